@@ -26,66 +26,277 @@
 
 #include "PoissonDiskDistribution.h"
 
-#include "cinder/Rand.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+#if defined( _WIN32 )
+	#if ! defined( NOMINMAX )
+		#define NOMINMAX
+	#endif
+	#if ! defined( WIN32_LEAN_AND_MEAN )
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+	#include <intrin.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#if ! defined( POISSON_DISK_NO_SIMD )
+	#if defined( __AVX__ )
+		#include <immintrin.h>
+		#define POISSON_DISK_AVX
+	#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#include <emmintrin.h>
+		#define POISSON_DISK_SSE2
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+		#include <arm_neon.h>
+		#define POISSON_DISK_NEON
+	#endif
+#endif
+
 #include "cinder/Log.h"
+#include "cinder/TriMesh.h"
 
 using namespace std;
 using namespace ci;
+using namespace poisson_detail;
 
-namespace {	
-	class Grid {
-	public:
-		using Cell = std::vector<vec2>;
+namespace poisson_detail {
+	namespace {
+		ivec3 toCellCoords( const vec2 &v ) { return ivec3( (int) floor( v.x ), (int) floor( v.y ), 0 ); }
+		ivec3 toCellCoords( const vec3 &v ) { return ivec3( (int) floor( v.x ), (int) floor( v.y ), (int) floor( v.z ) ); }
+		ivec3 toNumCells( const vec2 &v ) { return ivec3( (int) ceil( v.x ), (int) ceil( v.y ), 1 ); }
+		ivec3 toNumCells( const vec3 &v ) { return ivec3( (int) ceil( v.x ), (int) ceil( v.y ), (int) ceil( v.z ) ); }
+		bool isInside( const vec2 &min, const vec2 &max, const vec2 &p ) { return p.x >= min.x && p.y >= min.y && p.x <= max.x && p.y <= max.y; }
+		bool isInside( const vec3 &min, const vec3 &max, const vec3 &p ) { return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y && p.z <= max.z; }
 		
-		Grid( const ci::Area &bounds, uint32_t k );
+		// empty slots are far enough for their squared distance to fail any test without overflowing
+		const float kEmptySlot = 1e18f;
+		// the slot coordinates are padded with empty slots so that the vectorized test can read whole vectors past the last slot
+		const size_t kSlotPadding = 8;
 		
-		void add( const ci::vec2 &position );
-		bool hasNeighbors( const ci::vec2 &p, float radius );
+		//! returns whether one of the \a count points stored in \a xs, \a ys and \a zs is closer to \a p than \a sqRadius. Vectorized with AVX, SSE2 or NEON when available, in which case \a count is rounded up to a whole number of vectors. The extra slots belong to the next cells or to the padding, testing them can't give a wrong result.
+		template<int kDimensions>
+		bool hasPointsWithin( const float *xs, const float *ys, const float *zs, size_t count, const float *p, float sqRadius )
+		{
+			size_t i = 0;
+#if defined( POISSON_DISK_AVX )
+			const __m256 px = _mm256_set1_ps( p[0] ), py = _mm256_set1_ps( p[1] ), pz = _mm256_set1_ps( kDimensions == 3 ? p[2] : 0.0f ), r = _mm256_set1_ps( sqRadius );
+			for( ; i + 4 < count; i += 8 ) {
+				__m256 dx = _mm256_sub_ps( _mm256_loadu_ps( xs + i ), px );
+				__m256 dy = _mm256_sub_ps( _mm256_loadu_ps( ys + i ), py );
+				__m256 d = _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) );
+				if( kDimensions == 3 ) {
+					__m256 dz = _mm256_sub_ps( _mm256_loadu_ps( zs + i ), pz );
+					d = _mm256_add_ps( d, _mm256_mul_ps( dz, dz ) );
+				}
+				if( _mm256_movemask_ps( _mm256_cmp_ps( d, r, _CMP_LT_OQ ) ) ) {
+					return true;
+				}
+			}
+#endif
+#if defined( POISSON_DISK_AVX ) || defined( POISSON_DISK_SSE2 )
+			const __m128 px4 = _mm_set1_ps( p[0] ), py4 = _mm_set1_ps( p[1] ), pz4 = _mm_set1_ps( kDimensions == 3 ? p[2] : 0.0f ), r4 = _mm_set1_ps( sqRadius );
+			for( ; i < count; i += 4 ) {
+				__m128 dx = _mm_sub_ps( _mm_loadu_ps( xs + i ), px4 );
+				__m128 dy = _mm_sub_ps( _mm_loadu_ps( ys + i ), py4 );
+				__m128 d = _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) );
+				if( kDimensions == 3 ) {
+					__m128 dz = _mm_sub_ps( _mm_loadu_ps( zs + i ), pz4 );
+					d = _mm_add_ps( d, _mm_mul_ps( dz, dz ) );
+				}
+				if( _mm_movemask_ps( _mm_cmplt_ps( d, r4 ) ) ) {
+					return true;
+				}
+			}
+#elif defined( POISSON_DISK_NEON )
+			const float32x4_t px4 = vdupq_n_f32( p[0] ), py4 = vdupq_n_f32( p[1] ), pz4 = vdupq_n_f32( kDimensions == 3 ? p[2] : 0.0f ), r4 = vdupq_n_f32( sqRadius );
+			for( ; i < count; i += 4 ) {
+				float32x4_t dx = vsubq_f32( vld1q_f32( xs + i ), px4 );
+				float32x4_t dy = vsubq_f32( vld1q_f32( ys + i ), py4 );
+				float32x4_t d = vaddq_f32( vmulq_f32( dx, dx ), vmulq_f32( dy, dy ) );
+				if( kDimensions == 3 ) {
+					float32x4_t dz = vsubq_f32( vld1q_f32( zs + i ), pz4 );
+					d = vaddq_f32( d, vmulq_f32( dz, dz ) );
+				}
+				uint32x4_t lt = vcltq_f32( d, r4 );
+				uint32x2_t any = vorr_u32( vget_low_u32( lt ), vget_high_u32( lt ) );
+				if( vget_lane_u32( vpmax_u32( any, any ), 0 ) ) {
+					return true;
+				}
+			}
+#endif
+			for( ; i < count; i++ ) {
+				float dx = xs[i] - p[0];
+				float dy = ys[i] - p[1];
+				float d = dx * dx + dy * dy;
+				if( kDimensions == 3 ) {
+					float dz = zs[i] - p[2];
+					d += dz * dz;
+				}
+				if( d < sqRadius ) {
+					return true;
+				}
+			}
+			return false;
+		}
 		
-		void resize( const ci::Area &bounds, uint32_t k );
-		void resize( uint32_t k );
+		//! largest number of cells per query and of points a batch of neighbor queries gathers before falling back to one query per point. Gathering a window visits every one of its cells once, which pays off when it's not much larger than the windows of the single queries, like the 9x9 cells around a batch of candidates in 2D.
+		const int kMaxBatchCellsPerQuery	= 8;
+		const size_t kMaxBatchPoints		= 256;
 		
-	protected:
-		std::vector<Cell>	mGrid;
-		ci::ivec2			mNumCells, mOffset;
-		ci::Area			mBounds;
-		uint32_t			mK, mCellSize;
-	};
+		//! Points of the union of the windows of a batch of neighbor queries, gathered once in a compact structure of arrays. The queries of a batch surround the same active point so their windows overlap almost entirely, and each of them then tests the few gathered points with whole vectors instead of visiting the cells of its own window.
+		template<typename VecT>
+		struct QueryBatch {
+			static const int kDimensions = GridTraits<VecT>::kDimensions;
+			
+			//! sets the box around \a count \a points that the gathered points have to overlap. The box is widened by a small relative margin so that rounding can't drop a point a single query would find.
+			QueryBatch( const VecT *points, size_t count, float radius )
+			: mMin( points[0] ), mMax( points[0] ), mNumPoints( 0 )
+			{
+				for( size_t i = 1; i < count; i++ ) {
+					mMin = glm::min( mMin, points[i] );
+					mMax = glm::max( mMax, points[i] );
+				}
+				VecT margin = VecT( radius ) + ( glm::abs( mMin ) + glm::abs( mMax ) + VecT( radius ) ) * 1e-5f;
+				mMin -= margin;
+				mMax += margin;
+			}
+			
+			//! gathers the point at \a x, \a y and \a z if it is inside the box. Branchless, the point is always written and only counted when inside, the caller checks that there's room for it.
+			void add( float x, float y, float z )
+			{
+				mCoords[0][mNumPoints] = x;
+				mCoords[1][mNumPoints] = y;
+				mCoords[2][mNumPoints] = z;
+				bool isInside = x >= mMin.x && x <= mMax.x && y >= mMin.y && y <= mMax.y && ( kDimensions == 2 || ( z >= mMin[kDimensions - 1] && z <= mMax[kDimensions - 1] ) );
+				mNumPoints += isInside;
+			}
+			//! returns whether \a count more points can be gathered
+			bool hasRoom( size_t count ) const { return mNumPoints + count <= kMaxBatchPoints; }
+			void add( const VecT &p ) { add( p.x, p.y, kDimensions == 3 ? p[kDimensions - 1] : 0.0f ); }
+			
+			//! writes to \a results whether each of the \a count \a points is closer than \a radius to one of the gathered points
+			void test( const VecT *points, size_t count, float radius, bool *results )
+			{
+				// pad the gathered points so that the vectorized test can read whole vectors past the last one
+				for( size_t i = mNumPoints; i < mNumPoints + kSlotPadding; i++ ) {
+					mCoords[0][i] = mCoords[1][i] = mCoords[2][i] = kEmptySlot;
+				}
+				for( size_t i = 0; i < count; i++ ) {
+					results[i] = hasPointsWithin<kDimensions>( mCoords[0], mCoords[1], mCoords[2], mNumPoints, &points[i][0], radius * radius );
+				}
+			}
+			
+			VecT	mMin, mMax;
+			float	mCoords[3][kMaxBatchPoints + kSlotPadding];
+			size_t	mNumPoints;
+		};
+	} // anonymous namespace
+	
+	template<typename VecT>
+	Grid<VecT>::Grid()
+	: mNumCells( 1 ), mMin( 0.0f ), mMax( 0.0f ), mCellSize( 1.0f ), mInvCellSize( 1.0f ), mCellCapacity( 1 ), mStats( nullptr )
+	{
+	}
 	
+	template<typename VecT>
+	Grid<VecT>::Grid( const BoundsT &bounds, float cellSize, uint32_t cellCapacity )
+	: Grid()
+	{
+		resize( bounds, cellSize, cellCapacity );
+	}
+	
+	template<typename VecT>
+	ivec3 Grid<VecT>::getCellCoords( const VecT &position ) const
+	{
+		return toCellCoords( ( position - mMin ) * mInvCellSize );
+	}
 	
-	Grid::Grid( const Area &bounds, uint32_t k )
+	template<typename VecT>
+	int32_t Grid<VecT>::getCellIndex( const VecT &position ) const
 	{
-		resize( bounds, k );
+		if( ! isInside( mMin, mMax, position ) ) {
+			return -1;
+		}
+		// points lying exactly on the upper edges belong to the last row / column / layer
+		ivec3 cell = glm::min( getCellCoords( position ), mNumCells - ivec3( 1 ) );
+		return cell.x + mNumCells.x * ( cell.y + mNumCells.y * cell.z );
 	}
 	
-	void Grid::add( const ci::vec2 &position )
+	template<typename VecT>
+	int32_t Grid<VecT>::add( const VecT &position )
 	{
-		int x = ( ( uint32_t ) position.x + mOffset.x ) >> mK;
-		int y = ( ( uint32_t ) position.y + mOffset.y ) >> mK;
-		int j = x + mNumCells.x*y;
+		int32_t index = static_cast<int32_t>( mPoints.size() );
+		mPoints.push_back( position );
 		
-		if( j < mGrid.size() ){
-			mGrid[j].push_back( position );
+		int32_t j = getCellIndex( position );
+		if( j >= 0 ){
+			// find the first empty slot of the cell or fallback to the overflow list
+			int32_t *slots = &mCells[j * mCellCapacity];
+			for( uint32_t i = 0; i < mCellCapacity; i++ ) {
+				if( slots[i] < 0 ) {
+					slots[i] = index;
+					setSlotPosition( j * mCellCapacity + i, position );
+					return index;
+				}
+			}
+			auto it = upper_bound( mOverflow.begin(), mOverflow.end(), j, []( int32_t cell, const ivec2 &entry ) { return cell < entry.x; } );
+			mOverflow.insert( it, ivec2( j, index ) );
 		}
 		else {
 			CI_LOG_E( "Out of bounds" );
 		}
+		return index;
 	}
 	
-	bool Grid::hasNeighbors( const ci::vec2 &p, float radius )
+	template<typename VecT>
+	bool Grid<VecT>::hasNeighbors( const VecT &p, float radius ) const
 	{
+		const int dimensions = GridTraits<VecT>::kDimensions;
 		float sqRadius	= radius * radius;
-		ivec2 radiusVec = ivec2( radius );
-		ivec2 min       = glm::max( glm::min( ivec2( p ) - radiusVec, ivec2( mBounds.getLR() ) - ivec2( 1 ) ), ivec2( mBounds.getUL() ) );
-		ivec2 max       = glm::max( glm::min( ivec2( p ) + radiusVec, ivec2( mBounds.getLR() ) - ivec2( 1 ) ), ivec2( mBounds.getUL() ) );
-		
-		ivec2 minCell( ( min.x + mOffset.x ) >> mK, ( min.y + mOffset.y ) >> mK );
-		ivec2 maxCell = glm::min( 1 + ivec2( ( max.x + mOffset.x ) >> mK, ( max.y + mOffset.y ) >> mK ), mNumCells );
-		for( unsigned y = minCell.y; y < maxCell.y; y++ ) {
-			for( unsigned x = minCell.x; x < maxCell.x; x++ ) {
-				for( auto cell : mGrid[ x + mNumCells.x*y ] ) {
-					if( glm::length2( p - cell ) < sqRadius ){
-						return true;
+		ivec3 minCell	= glm::max( getCellCoords( p - VecT( radius ) ), ivec3( 0 ) );
+		ivec3 maxCell	= glm::min( getCellCoords( p + VecT( radius ) ) + ivec3( 1 ), mNumCells );
+		POISSON_DISK_STAT( if( mStats ) { mStats->mNumNeighborQueries++; } )
+		// the window is the exact bounding box of the disk / sphere. With a single point per cell it's at most 4x4 cells
+		// in 2D, never more than the 5x5 minus corners stencil, and its rows are tested with whole vectors so culling
+		// the cells of its corners doesn't save any work
+		int rowLength = maxCell.x - minCell.x;
+		// negative radii and queries outside of the grid along x have no cells to visit
+		if( rowLength <= 0 ) {
+			return false;
+		}
+		for( int z = minCell.z; z < maxCell.z; z++ ) {
+			for( int y = minCell.y; y < maxCell.y; y++ ) {
+				// the slots of a row of cells are contiguous and tested at once
+				int32_t first = minCell.x + mNumCells.x * ( y + mNumCells.y * z );
+				size_t slot = first * mCellCapacity;
+				POISSON_DISK_STAT( if( mStats ) { mStats->mNumCellsVisited += rowLength; mStats->mNumPointsCompared += rowLength * mCellCapacity; } )
+				if( hasPointsWithin<dimensions>( &mSlotCoords[0][slot], &mSlotCoords[1][slot], dimensions == 3 ? &mSlotCoords[2][slot] : nullptr, rowLength * mCellCapacity, &p[0], sqRadius ) ) {
+					return true;
+				}
+				
+				// only full cells can have points in the overflow list
+				if( ! mOverflow.empty() ) {
+					for( int32_t j = first; j < first + rowLength; j++ ) {
+						if( mCells[( j + 1 ) * mCellCapacity - 1] >= 0 ) {
+							auto it = lower_bound( mOverflow.begin(), mOverflow.end(), j, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+							for( ; it != mOverflow.end() && it->x == j; ++it ) {
+								POISSON_DISK_STAT( if( mStats ) { mStats->mNumPointsCompared++; } )
+								if( glm::length2( p - mPoints[it->y] ) < sqRadius ){
+									return true;
+								}
+							}
+						}
 					}
 				}
 			}
@@ -93,193 +304,2440 @@ namespace {
 		return false;
 	}
 	
-	void Grid::resize( const Area &bounds, uint32_t k )
+	template<typename VecT>
+	void Grid<VecT>::hasNeighbors( const VecT *points, size_t count, float radius, bool *results ) const
 	{
-		mBounds = bounds;
-		resize( k );
+		// in 3D the union of the windows is more than ten times larger than a single one and is never worth gathering
+		if( GridTraits<VecT>::kDimensions == 2 && count > 1 && radius > 0.0f && hasNeighborsInWindow( points, count, radius, results ) ) {
+			return;
+		}
+		// single queries, negative radii and windows too large to be gathered visit the cells of each point
+		for( size_t i = 0; i < count; i++ ) {
+			results[i] = hasNeighbors( points[i], radius );
+		}
 	}
-	void Grid::resize( uint32_t k )
+	
+	template<typename VecT>
+	bool Grid<VecT>::hasNeighborsInWindow( const VecT *points, size_t count, float radius, bool *results ) const
 	{
-		mK          = k;
-		mCellSize   = 1 << k;
-		mOffset     = glm::abs( mBounds.getUL() );
-		mNumCells   = glm::ceil( vec2( mBounds.getSize() ) / (float) mCellSize );
-		mGrid.clear();
-		mGrid.resize( mNumCells.x * mNumCells.y );
+		const int dimensions = GridTraits<VecT>::kDimensions;
+		QueryBatch<VecT> batch( points, count, radius );
+		ivec3 minCell	= glm::max( getCellCoords( batch.mMin ), ivec3( 0 ) );
+		ivec3 maxCell	= glm::min( getCellCoords( batch.mMax ) + ivec3( 1 ), mNumCells );
+		ivec3 size		= maxCell - minCell;
+		if( size.x <= 0 || size.y <= 0 || size.z <= 0 || size.x * size.y * size.z > static_cast<int>( count ) * kMaxBatchCellsPerQuery ) {
+			return false;
+		}
+		for( int z = minCell.z; z < maxCell.z; z++ ) {
+			for( int y = minCell.y; y < maxCell.y; y++ ) {
+				int32_t first = minCell.x + mNumCells.x * ( y + mNumCells.y * z );
+				size_t firstSlot = first * mCellCapacity, lastSlot = ( first + size.x ) * mCellCapacity;
+				if( ! batch.hasRoom( lastSlot - firstSlot ) ) {
+					return false;
+				}
+				for( size_t slot = firstSlot; slot < lastSlot; slot++ ) {
+					batch.add( mSlotCoords[0][slot], mSlotCoords[1][slot], dimensions == 3 ? mSlotCoords[2][slot] : 0.0f );
+				}
+				// only full cells can have points in the overflow list
+				for( int32_t j = first; ! mOverflow.empty() && j < first + size.x; j++ ) {
+					if( mCells[( j + 1 ) * mCellCapacity - 1] >= 0 ) {
+						auto it = lower_bound( mOverflow.begin(), mOverflow.end(), j, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+						for( ; it != mOverflow.end() && it->x == j; ++it ) {
+							if( ! batch.hasRoom( 1 ) ) {
+								return false;
+							}
+							batch.add( mPoints[it->y] );
+						}
+					}
+				}
+			}
+		}
+		POISSON_DISK_STAT( if( mStats ) { mStats->mNumNeighborQueries += count; mStats->mNumCellsVisited += size.x * size.y * size.z; mStats->mNumPointsCompared += count * batch.mNumPoints; } )
+		batch.test( points, count, radius, results );
+		return true;
 	}
-} // anonymous namespace
-
-std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, int k )
-{
-	// prepare working structures
-	vector<vec2> processingList;
-	vector<vec2> outputList;
 	
-	// create grid
-	Grid grid( Area( bounds ), 3 );
-	
-	// add the initial points
-	for( auto p : initialSet ){
-		processingList.push_back( p );
-		outputList.push_back( p );
-		grid.add( p );
+	template<typename VecT>
+	void Grid<VecT>::setSlotPosition( size_t slot, const VecT &position )
+	{
+		for( int c = 0; c < GridTraits<VecT>::kDimensions; c++ ) {
+			mSlotCoords[c][slot] = position[c];
+		}
 	}
 	
-	// if there's no initial points add the center point
-	if( !processingList.size() ){
-		processingList.push_back( bounds.getCenter() );
-		outputList.push_back( bounds.getCenter() );
-		grid.add( bounds.getCenter() );
+	template<typename VecT>
+	void Grid<VecT>::clearSlots( size_t first, size_t last )
+	{
+		fill( mCells.begin() + first, mCells.begin() + last, -1 );
+		for( int c = 0; c < GridTraits<VecT>::kDimensions; c++ ) {
+			fill( mSlotCoords[c].begin() + first, mSlotCoords[c].begin() + last, kEmptySlot );
+		}
 	}
 	
-	// while there's points in the processing list
-	while( processingList.size() ){
-		
-		// pick a random point in the processing list
-		int randPoint = randInt( 0, processingList.size() - 1 );
-		vec2 center = processingList[randPoint];
+	template<typename VecT>
+	void Grid<VecT>::remove( int32_t index )
+	{
+		// unlink the point from its cell, keeping the slots packed and refilling the last one from the overflow list
+		int32_t j = getCellIndex( mPoints[index] );
+		if( j >= 0 ) {
+			int32_t *slots = &mCells[j * mCellCapacity];
+			auto first = lower_bound( mOverflow.begin(), mOverflow.end(), j, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+			int32_t *slot = find( slots, slots + mCellCapacity, index );
+			if( slot != slots + mCellCapacity ) {
+				size_t begin = j * mCellCapacity, end = begin + mCellCapacity, i = begin + ( slot - slots );
+				copy( slot + 1, slots + mCellCapacity, slot );
+				for( int c = 0; c < GridTraits<VecT>::kDimensions; c++ ) {
+					copy( mSlotCoords[c].begin() + i + 1, mSlotCoords[c].begin() + end, mSlotCoords[c].begin() + i );
+				}
+				clearSlots( end - 1, end );
+				if( first != mOverflow.end() && first->x == j ) {
+					slots[mCellCapacity - 1] = first->y;
+					setSlotPosition( end - 1, mPoints[first->y] );
+					mOverflow.erase( first );
+				}
+			}
+			else {
+				for( auto it = first; it != mOverflow.end() && it->x == j; ++it ) {
+					if( it->y == index ) {
+						mOverflow.erase( it );
+						break;
+					}
+				}
+			}
+		}
 		
-		// remove it
-		processingList.erase( processingList.begin() + randPoint );
+		// move the last point to the freed index
+		int32_t last = static_cast<int32_t>( mPoints.size() ) - 1;
+		if( index != last ) {
+			int32_t k = getCellIndex( mPoints[last] );
+			if( k >= 0 ) {
+				int32_t *slots = &mCells[k * mCellCapacity];
+				int32_t *slot = find( slots, slots + mCellCapacity, last );
+				if( slot != slots + mCellCapacity ) {
+					*slot = index;
+				}
+				else {
+					auto it = lower_bound( mOverflow.begin(), mOverflow.end(), k, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+					for( ; it != mOverflow.end() && it->x == k; ++it ) {
+						if( it->y == last ) {
+							it->y = index;
+							break;
+						}
+					}
+				}
+			}
+			mPoints[index] = mPoints[last];
+		}
+		mPoints.pop_back();
+	}
+	
+	template<typename VecT>
+	void Grid<VecT>::getPointsInCells( const VecT &min, const VecT &max, std::vector<int32_t> *indices ) const
+	{
+		ivec3 minCell	= glm::max( getCellCoords( min ), ivec3( 0 ) );
+		ivec3 maxCell	= glm::min( getCellCoords( max ) + ivec3( 1 ), mNumCells );
+		for( int z = minCell.z; z < maxCell.z; z++ ) {
+			for( int y = minCell.y; y < maxCell.y; y++ ) {
+				for( int x = minCell.x; x < maxCell.x; x++ ) {
+					int32_t j			= x + mNumCells.x * ( y + mNumCells.y * z );
+					const int32_t *slots = &mCells[j * mCellCapacity];
+					for( uint32_t i = 0; i < mCellCapacity && slots[i] >= 0; i++ ) {
+						indices->push_back( slots[i] );
+					}
+					if( slots[mCellCapacity - 1] >= 0 && ! mOverflow.empty() ) {
+						auto it = lower_bound( mOverflow.begin(), mOverflow.end(), j, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+						for( ; it != mOverflow.end() && it->x == j; ++it ) {
+							indices->push_back( it->y );
+						}
+					}
+				}
+			}
+		}
+	}
+	
+	template<typename VecT>
+	int32_t Grid<VecT>::getNearest( const VecT &p, float maxDistance ) const
+	{
+		if( mCells.empty() ) {
+			return -1;
+		}
 		
-		// spawn k points in an anulus around that point
-		// the higher k is, the higher the packing will be and slower the algorithm
-		for( int i = 0; i < k; i++ ){
-			float randRadius	= separation * ( 1.0f + randFloat() );
-			float randAngle		= randFloat() * M_PI * 2.0f;
-			vec2 newPoint		= center + vec2( cos( randAngle ), sin( randAngle ) ) * randRadius;
-			
-			// check if the new random point is in the window bounds
-			// and if it has no neighbors that are too close to them
-			if( bounds.contains( newPoint )
-			   && !grid.hasNeighbors( newPoint, separation ) ){
-				
-				// if the point has no close neighbors add it to the processing list, output list and grid
-				processingList.push_back( newPoint );
-				outputList.push_back( newPoint );
-				grid.add( newPoint );
+		// the cells of ring r around the cell of p, clamped to the grid, are at least r - 1 cells away from p
+		ivec3 center		= glm::clamp( getCellCoords( p ), ivec3( 0 ), mNumCells - ivec3( 1 ) );
+		int maxRing			= glm::max( mNumCells.x, glm::max( mNumCells.y, mNumCells.z ) );
+		int32_t nearest		= -1;
+		float nearestDist2	= maxDistance < std::sqrt( numeric_limits<float>::max() ) ? maxDistance * maxDistance : numeric_limits<float>::max();
+		auto visit = [&]( int32_t index ) {
+			VecT d		= mPoints[index] - p;
+			float dist2	= glm::dot( d, d );
+			if( dist2 < nearestDist2 ) {
+				nearestDist2	= dist2;
+				nearest			= index;
+			}
+		};
+		for( int r = 0; r < maxRing && ( r == 0 || ( r - 1 ) * mCellSize * ( r - 1 ) * mCellSize < nearestDist2 ); r++ ) {
+			ivec3 minCell = glm::max( center - ivec3( r ), ivec3( 0 ) );
+			ivec3 maxCell = glm::min( center + ivec3( r ), mNumCells - ivec3( 1 ) );
+			for( int z = minCell.z; z <= maxCell.z; z++ ) {
+				for( int y = minCell.y; y <= maxCell.y; y++ ) {
+					bool isInnerRow = glm::abs( z - center.z ) < r && glm::abs( y - center.y ) < r;
+					for( int x = minCell.x; x <= maxCell.x; x++ ) {
+						// only the two ends of the rows crossing the ring are part of it
+						if( isInnerRow && glm::abs( x - center.x ) < r ) {
+							x = center.x + r - 1;
+							continue;
+						}
+						int32_t j			= x + mNumCells.x * ( y + mNumCells.y * z );
+						const int32_t *slots = &mCells[j * mCellCapacity];
+						for( uint32_t i = 0; i < mCellCapacity && slots[i] >= 0; i++ ) {
+							visit( slots[i] );
+						}
+						if( slots[mCellCapacity - 1] >= 0 && ! mOverflow.empty() ) {
+							auto it = lower_bound( mOverflow.begin(), mOverflow.end(), j, []( const ivec2 &entry, int32_t cell ) { return entry.x < cell; } );
+							for( ; it != mOverflow.end() && it->x == j; ++it ) {
+								visit( it->y );
+							}
+						}
+					}
+				}
 			}
 		}
+		return nearest;
 	}
 	
-	return outputList;
-}
-
-std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, int k )
-{
-	// prepare working structures
-	vector<vec2> processingList;
-	vector<vec2> outputList;
+	template<typename VecT>
+	bool Grid<VecT>::contains( const VecT &p ) const
+	{
+		return isInside( mMin, mMax, p );
+	}
 	
-	// create grid
-	Grid grid( Area( bounds ), 3 );
+	template<typename VecT>
+	void Grid<VecT>::reserve( size_t numPoints )
+	{
+		mPoints.reserve( numPoints );
+	}
 	
-	// add the initial points
-	for( auto p : initialSet ){
-		processingList.push_back( p );
-		outputList.push_back( p );
-		grid.add( p );
+	template<typename VecT>
+	void Grid<VecT>::resize( const BoundsT &bounds, float cellSize, uint32_t cellCapacity )
+	{
+		// clear before the bounds change so that the previous cells of the points are found
+		clear();
+		mMin = getMin( bounds );
+		mMax = getMax( bounds );
+		resize( cellSize, cellCapacity );
 	}
 	
-	// if there's no initial points add the center point
-	if( !processingList.size() ){
-		processingList.push_back( bounds.getCenter() );
-		outputList.push_back( bounds.getCenter() );
-		grid.add( bounds.getCenter() );
+	template<typename VecT>
+	void Grid<VecT>::resize( float cellSize, uint32_t cellCapacity )
+	{
+		// clear with the previous layout, every remaining cell is then empty and only the new ones need to be initialized
+		clear();
+		mCellSize		= cellSize;
+		mInvCellSize	= 1.0f / cellSize;
+		mCellCapacity	= glm::max( cellCapacity, 1u );
+		mNumCells		= glm::max( toNumCells( ( mMax - mMin ) * mInvCellSize ), ivec3( 1 ) );
+		size_t numSlots = mNumCells.x * mNumCells.y * mNumCells.z * mCellCapacity;
+		mCells.resize( numSlots, -1 );
+		for( int c = 0; c < GridTraits<VecT>::kDimensions; c++ ) {
+			mSlotCoords[c].resize( numSlots + kSlotPadding, kEmptySlot );
+		}
 	}
 	
-	// while there's points in the processing list
-	while( processingList.size() ){
-		
-		// pick a random point in the processing list
-		int randPoint = randInt( 0, processingList.size() - 1 );
-		vec2 center = processingList[randPoint];
+	template<typename VecT>
+	void Grid<VecT>::clear()
+	{
+		// sparse grids only reset the cells their points were added to
+		if( mPoints.size() * mCellCapacity * 4 < mCells.size() ) {
+			for( const auto &p : mPoints ) {
+				int32_t j = getCellIndex( p );
+				if( j >= 0 ) {
+					clearSlots( j * mCellCapacity, ( j + 1 ) * mCellCapacity );
+				}
+			}
+		}
+		else {
+			clearSlots( 0, mCells.size() );
+		}
+		mPoints.clear();
+		mOverflow.clear();
+	}
+	
+	template class Grid<vec2>;
+	template class Grid<vec3>;
+	
+	template<typename VecT>
+	MultiLevelGrid<VecT>::MultiLevelGrid()
+	: mMin( 0.0f ), mMax( 0.0f ), mMinSeparation( 1.0f ), mNumLevels( 0 ), mNumReservedPoints( 0 ), mStats( nullptr )
+	{
+	}
+	
+	template<typename VecT>
+	MultiLevelGrid<VecT>::MultiLevelGrid( const BoundsT &bounds, float minSeparation, float maxSeparation )
+	: MultiLevelGrid()
+	{
+		resize( bounds, minSeparation, maxSeparation );
+	}
+	
+	template<typename VecT>
+	int32_t MultiLevelGrid<VecT>::add( const VecT &position )
+	{
+		int32_t index = static_cast<int32_t>( mPoints.size() );
+		mPoints.push_back( position );
+		bool inside = contains( position );
+		for( size_t l = 0; l < mNumLevels; l++ ) {
+			Level &level = mLevels[l];
+			int32_t next = -1;
+			if( inside ) {
+				ivec3 c		= glm::min( toCellCoords( ( position - mMin ) * level.mInvCellSize ), level.mNumCells - ivec3( 1 ) );
+				int32_t j	= c.x + level.mNumCells.x * ( c.y + level.mNumCells.y * c.z );
+				next		= level.mHeads[j];
+				level.mHeads[j] = index;
+			}
+			level.mNext.push_back( next );
+		}
+		if( ! inside ) {
+			CI_LOG_E( "Out of bounds" );
+		}
+		return index;
+	}
+	
+	template<typename VecT>
+	bool MultiLevelGrid<VecT>::hasNeighbors( const VecT &p, float radius ) const
+	{
+		// use the finest level whose cells are at least as large as the radius, the window is then at most 3 cells wide
+		size_t l = 0;
+		while( l + 1 < mNumLevels && mLevels[l].mCellSize < radius ) {
+			l++;
+		}
 		
-		// remove it
-		processingList.erase( processingList.begin() + randPoint );
+		const Level &level	= mLevels[l];
+		float sqRadius		= radius * radius;
+		ivec3 minCell		= glm::max( toCellCoords( ( p - VecT( radius ) - mMin ) * level.mInvCellSize ), ivec3( 0 ) );
+		ivec3 maxCell		= glm::min( toCellCoords( ( p + VecT( radius ) - mMin ) * level.mInvCellSize ) + ivec3( 1 ), level.mNumCells );
+		POISSON_DISK_STAT( if( mStats ) { mStats->mNumNeighborQueries++; } )
+		for( int z = minCell.z; z < maxCell.z; z++ ) {
+			for( int y = minCell.y; y < maxCell.y; y++ ) {
+				for( int x = minCell.x; x < maxCell.x; x++ ) {
+					int32_t j = x + level.mNumCells.x * ( y + level.mNumCells.y * z );
+					if( level.mHeads[j] < 0 ) {
+						continue;
+					}
+					// the cells are large enough to hold many points of the finer regions, skip the ones outside of the radius
+					VecT cellMin = mMin + toVec( ivec3( x, y, z ), p ) * level.mCellSize;
+					if( glm::length2( glm::max( glm::max( cellMin - p, p - cellMin - VecT( level.mCellSize ) ), VecT( 0.0f ) ) ) >= sqRadius ) {
+						continue;
+					}
+					POISSON_DISK_STAT( if( mStats ) { mStats->mNumCellsVisited++; } )
+					for( int32_t i = level.mHeads[j]; i >= 0; i = level.mNext[i] ) {
+						POISSON_DISK_STAT( if( mStats ) { mStats->mNumPointsCompared++; } )
+						if( glm::length2( p - mPoints[i] ) < sqRadius ) {
+							return true;
+						}
+					}
+				}
+			}
+		}
+		return false;
+	}
+	
+	template<typename VecT>
+	void MultiLevelGrid<VecT>::hasNeighbors( const VecT *points, size_t count, float radius, bool *results ) const
+	{
+		// in 3D the union of the windows is more than ten times larger than a single one and is never worth gathering
+		if( GridTraits<VecT>::kDimensions == 2 && count > 1 && radius > 0.0f && hasNeighborsInWindow( points, count, radius, results ) ) {
+			return;
+		}
+		// single queries, negative radii and windows too large to be gathered visit the cells of each point
+		for( size_t i = 0; i < count; i++ ) {
+			results[i] = hasNeighbors( points[i], radius );
+		}
+	}
+	
+	template<typename VecT>
+	bool MultiLevelGrid<VecT>::hasNeighborsInWindow( const VecT *points, size_t count, float radius, bool *results ) const
+	{
+		// same level as the single queries
+		size_t l = 0;
+		while( l + 1 < mNumLevels && mLevels[l].mCellSize < radius ) {
+			l++;
+		}
 		
-		// get the current min distance
-		float dist = distFunction( center );
+		const Level &level	= mLevels[l];
+		QueryBatch<VecT> batch( points, count, radius );
+		ivec3 minCell		= glm::max( toCellCoords( ( batch.mMin - mMin ) * level.mInvCellSize ), ivec3( 0 ) );
+		ivec3 maxCell		= glm::min( toCellCoords( ( batch.mMax - mMin ) * level.mInvCellSize ) + ivec3( 1 ), level.mNumCells );
+		ivec3 size			= maxCell - minCell;
+		if( size.x <= 0 || size.y <= 0 || size.z <= 0 || size.x * size.y * size.z > static_cast<int>( count ) * kMaxBatchCellsPerQuery ) {
+			return false;
+		}
+		for( int z = minCell.z; z < maxCell.z; z++ ) {
+			for( int y = minCell.y; y < maxCell.y; y++ ) {
+				for( int x = minCell.x; x < maxCell.x; x++ ) {
+					int32_t j = x + level.mNumCells.x * ( y + level.mNumCells.y * z );
+					for( int32_t i = level.mHeads[j]; i >= 0; i = level.mNext[i] ) {
+						if( ! batch.hasRoom( 1 ) ) {
+							return false;
+						}
+						batch.add( mPoints[i] );
+					}
+				}
+			}
+		}
+		POISSON_DISK_STAT( if( mStats ) { mStats->mNumNeighborQueries += count; mStats->mNumCellsVisited += size.x * size.y * size.z; mStats->mNumPointsCompared += count * batch.mNumPoints; } )
+		batch.test( points, count, radius, results );
+		return true;
+	}
+	
+	template<typename VecT>
+	bool MultiLevelGrid<VecT>::contains( const VecT &p ) const
+	{
+		return isInside( mMin, mMax, p );
+	}
+	
+	template<typename VecT>
+	std::vector<VecT> MultiLevelGrid<VecT>::releasePoints()
+	{
+		clearCells();
+		return std::move( mPoints );
+	}
+	
+	template<typename VecT>
+	void MultiLevelGrid<VecT>::reserve( size_t numPoints )
+	{
+		// levels created by the next resizes reserve the same number of points
+		mNumReservedPoints = glm::max( mNumReservedPoints, numPoints );
+		mPoints.reserve( numPoints );
+		for( auto &level : mLevels ) {
+			level.mNext.reserve( numPoints );
+		}
+	}
+	
+	template<typename VecT>
+	void MultiLevelGrid<VecT>::resize( const BoundsT &bounds, float minSeparation, float maxSeparation )
+	{
+		// clear with the previous layout, every remaining cell is then empty and only the new ones need to be initialized
+		clear();
+		mMin			= getMin( bounds );
+		mMax			= getMax( bounds );
+		mMinSeparation	= glm::max( minSeparation, 1e-3f );
 		
-		// spawn k points in an anulus around that point
-		// the higher k is, the higher the packing will be and slower the algorithm
-		for( int i = 0; i < k; i++ ){
-			float randRadius	= dist * ( 1.0f + randFloat() );
-			float randAngle		= randFloat() * M_PI * 2.0f;
-			vec2 newPoint		= center + vec2( cos( randAngle ), sin( randAngle ) ) * randRadius;
-			
-			// check if the new random point is in the window bounds
-			// and if it has no neighbors that are too close to them
-			if( bounds.contains( newPoint )
-			   && !grid.hasNeighbors( newPoint, dist ) ){
-				
-				// if the point has no close neighbors add it to the processing list, output list and grid
-				processingList.push_back( newPoint );
-				outputList.push_back( newPoint );
-				grid.add( newPoint );
+		// the cells of the first level are as large as the minimum separation and double until they reach the maximum one
+		mNumLevels = 1;
+		while( mNumLevels < 32 && mMinSeparation * static_cast<float>( 1u << ( mNumLevels - 1 ) ) < maxSeparation ) {
+			mNumLevels++;
+		}
+		if( mLevels.size() < mNumLevels ) {
+			mLevels.resize( mNumLevels );
+		}
+		for( size_t l = 0; l < mNumLevels; l++ ) {
+			Level &level		= mLevels[l];
+			level.mCellSize		= mMinSeparation * static_cast<float>( 1u << l );
+			level.mInvCellSize	= 1.0f / level.mCellSize;
+			level.mNumCells		= glm::max( toNumCells( ( mMax - mMin ) * level.mInvCellSize ), ivec3( 1 ) );
+			level.mHeads.resize( level.mNumCells.x * level.mNumCells.y * level.mNumCells.z, -1 );
+			level.mNext.clear();
+			level.mNext.reserve( mNumReservedPoints );
+		}
+	}
+	
+	template<typename VecT>
+	void MultiLevelGrid<VecT>::clear()
+	{
+		clearCells();
+		mPoints.clear();
+	}
+	
+	template<typename VecT>
+	void MultiLevelGrid<VecT>::clearCells()
+	{
+		for( size_t l = 0; l < mNumLevels; l++ ) {
+			Level &level = mLevels[l];
+			// sparse levels only reset the cells their points were added to
+			if( mPoints.size() * 4 < level.mHeads.size() ) {
+				for( const auto &p : mPoints ) {
+					if( contains( p ) ) {
+						ivec3 c = glm::min( toCellCoords( ( p - mMin ) * level.mInvCellSize ), level.mNumCells - ivec3( 1 ) );
+						level.mHeads[c.x + level.mNumCells.x * ( c.y + level.mNumCells.y * c.z )] = -1;
+					}
+				}
 			}
+			else {
+				fill( level.mHeads.begin(), level.mHeads.end(), -1 );
+			}
+			level.mNext.clear();
 		}
 	}
 	
-	return outputList;
-}
-
-std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, int k )
-{
-	// prepare working structures
-	vector<vec2> processingList;
-	vector<vec2> outputList;
+	template class MultiLevelGrid<vec2>;
+	template class MultiLevelGrid<vec3>;
+	
+	float getCellSize( float minSeparation, float maxSeparation, int dimensions )
+	{
+		return glm::max( glm::sqrt( minSeparation * maxSeparation ) / sqrt( (float) dimensions ), 1e-3f );
+	}
 	
-	// create grid
-	Grid grid( Area( bounds ), 3 );
+	uint32_t getCellCapacity( float cellSize, float minSeparation, int dimensions )
+	{
+		if( cellSize * sqrt( (float) dimensions ) <= minSeparation * 1.0001f ) {
+			return 1;
+		}
+		// densest packings: 2/sqrt(3) points per r^2 in 2D and sqrt(2) points per r^3 in 3D
+		float ratio = cellSize / minSeparation;
+		float numPoints = dimensions == 2 ? ratio * ratio * 1.1547f : ratio * ratio * ratio * 1.4142f;
+		return glm::clamp( (uint32_t) glm::ceil( numPoints ) + 1, 1u, 8u );
+	}
 	
-	// add the initial points
-	for( auto p : initialSet ){
-		processingList.push_back( p );
-		outputList.push_back( p );
-		grid.add( p );
+	size_t getMaxNumPoints( const ci::Rectf &bounds, float minSeparation )
+	{
+		// disks of radius minSeparation / 2 centered inside the bounds don't overlap and fit in the bounds inflated by that radius
+		vec2 size = glm::abs( bounds.getSize() ) + vec2( minSeparation );
+		return static_cast<size_t>( size.x * size.y * 1.1547f / ( minSeparation * minSeparation ) ) + 1;
 	}
 	
-	// if there's no initial points add the center point
-	if( !processingList.size() ){
-		processingList.push_back( bounds.getCenter() );
-		outputList.push_back( bounds.getCenter() );
-		grid.add( bounds.getCenter() );
+	size_t getMaxNumPoints( const ci::AxisAlignedBox &bounds, float minSeparation )
+	{
+		vec3 size = glm::abs( bounds.getMax() - bounds.getMin() ) + vec3( minSeparation );
+		return static_cast<size_t>( size.x * size.y * size.z * 1.4142f / ( minSeparation * minSeparation * minSeparation ) ) + 1;
 	}
 	
-	// while there's points in the processing list
-	while( processingList.size() ){
+	namespace {
+		//! fraction of the spread of the separations found by the probes of getSeparationRange added below and above them
+		const float kSeparationRangePadding = 0.5f;
 		
-		// pick a random point in the processing list
-		int randPoint = randInt( 0, processingList.size() - 1 );
-		vec2 center = processingList[randPoint];
+		vec2 padSeparationRange( const vec2 &range, const PoissonDiskOptions &options )
+		{
+			if( options.isTiled() || options.getEngine() == PoissonDiskOptions::DART_THROWING ) {
+				CI_LOG_W( "Tiled and dart throwing sampling clamp the separation to its range, pass the separation range explicitly instead of relying on an estimation" );
+			}
+			// constant separations keep an exact range, the minimum stays positive
+			float padding = ( range.y - range.x ) * kSeparationRangePadding;
+			return vec2( glm::max( range.x - padding, range.x * 0.5f ), range.y + padding );
+		}
+	}
+	
+	vec2 getSeparationRange( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &bounds, const PoissonDiskOptions &options )
+	{
+		const int numProbes = 16;
+		vec2 range( numeric_limits<float>::max(), 0.0f );
+		for( int y = 0; y <= numProbes; y++ ) {
+			for( int x = 0; x <= numProbes; x++ ) {
+				float dist = distFunction( bounds.getUpperLeft() + bounds.getSize() * vec2( x, y ) / (float) numProbes );
+				range = vec2( glm::min( range.x, dist ), glm::max( range.y, dist ) );
+			}
+		}
+		return padSeparationRange( range, options );
+	}
+	
+	vec2 getSeparationRange( const std::function<float(const glm::vec3&)> &distFunction, const ci::AxisAlignedBox &bounds, const PoissonDiskOptions &options )
+	{
+		const int numProbes = 8;
+		vec2 range( numeric_limits<float>::max(), 0.0f );
+		for( int z = 0; z <= numProbes; z++ ) {
+			for( int y = 0; y <= numProbes; y++ ) {
+				for( int x = 0; x <= numProbes; x++ ) {
+					float dist = distFunction( bounds.getMin() + ( bounds.getMax() - bounds.getMin() ) * vec3( x, y, z ) / (float) numProbes );
+					range = vec2( glm::min( range.x, dist ), glm::max( range.y, dist ) );
+				}
+			}
+		}
+		return padSeparationRange( range, options );
+	}
+	
+	const glm::vec2* getCircleDirections()
+	{
+		struct DirectionTable {
+			DirectionTable()
+			{
+				for( size_t i = 0; i < 256; i++ ) {
+					float angle = (float) i / 256.0f * 2.0f * (float) M_PI;
+					mDirections[i] = vec2( cos( angle ), sin( angle ) );
+				}
+			}
+			vec2 mDirections[256];
+		};
+		static const DirectionTable sTable;
+		return sTable.mDirections;
+	}
+	
+	const glm::vec3* getSphereDirections()
+	{
+		// fibonacci sphere
+		struct DirectionTable {
+			DirectionTable()
+			{
+				const float goldenAngle = (float) M_PI * ( 3.0f - sqrt( 5.0f ) );
+				for( size_t i = 0; i < 256; i++ ) {
+					float z			= 1.0f - ( 2.0f * i + 1.0f ) / 256.0f;
+					float radius	= sqrt( 1.0f - z * z );
+					float angle		= goldenAngle * i;
+					mDirections[i]	= vec3( cos( angle ) * radius, sin( angle ) * radius, z );
+				}
+			}
+			vec3 mDirections[256];
+		};
+		static const DirectionTable sTable;
+		return sTable.mDirections;
+	}
+	
+	void mergeStats( PoissonDiskStats *target, const PoissonDiskStats &stats )
+	{
+		static std::mutex sMutex;
+		if( target ) {
+			lock_guard<mutex> lock( sMutex );
+			*target += stats;
+		}
+	}
+	
+	SamplingBudget::SamplingBudget( const PoissonDiskOptions &options )
+		: mMaxPoints( options.getMaxPoints() ), mDeadline( options.getTimeBudget() > 0.0 ? getTime() + options.getTimeBudget() : 0.0 ), mNumPoints( 0 ), mIsExhausted( false )
+	{
+	}
+	
+	size_t getNumWorkers( const PoissonDiskOptions &options )
+	{
+		return options.getNumThreads() && ! options.getExecutor() ? options.getNumThreads() : std::max( std::thread::hardware_concurrency(), 1u );
+	}
+	
+	void parallelFor( size_t count, const std::function<void( size_t )> &task, const PoissonDiskOptions &options )
+	{
+		if( options.getExecutor() ) {
+			options.getExecutor()( count, task );
+			return;
+		}
 		
-		// remove it
-		processingList.erase( processingList.begin() + randPoint );
+		size_t numThreads = std::min( getNumWorkers( options ), count );
+		if( numThreads <= 1 ) {
+			for( size_t i = 0; i < count; i++ ) {
+				task( i );
+			}
+			return;
+		}
 		
-		// get the current min distance
-		float dist = distFunction( center );
+		// each thread picks the next task until there's none left
+		std::atomic<size_t> next( 0 );
+		auto worker = [&]() {
+			for( size_t i = next++; i < count; i = next++ ) {
+				task( i );
+			}
+		};
+		std::vector<std::thread> threads;
+		threads.reserve( numThreads - 1 );
+		for( size_t i = 0; i < numThreads - 1; i++ ) {
+			threads.emplace_back( worker );
+		}
+		worker();
+		for( auto &thread : threads ) {
+			thread.join();
+		}
+	}
+	
+	ChannelSeparation::ChannelSeparation( const ci::Channel32f &density, const ci::Rectf &area, float minSeparation, float maxSeparation )
+	: mData( reinterpret_cast<const uint8_t*>( density.getData() ) ), mRowBytes( density.getRowBytes() ), mIncrement( density.getIncrement() ),
+	mSize( glm::max( ivec2( density.getWidth(), density.getHeight() ), ivec2( 1 ) ) ), mMin( area.getUpperLeft() ), mScale( vec2( mSize ) / glm::max( area.getSize(), vec2( 1e-6f ) ) ),
+	mMaxCoords( vec2( mSize - ivec2( 1 ) ) ), mMinSeparation( minSeparation ), mMaxSeparation( maxSeparation )
+	{
+	}
+	
+	ChannelMask::ChannelMask( const ci::Channel8u &mask, const ci::Rectf &area, float cellSize )
+	: mData( mask.getData() ), mRowBytes( mask.getRowBytes() ), mIncrement( mask.getIncrement() ), mSize( glm::max( ivec2( mask.getWidth(), mask.getHeight() ), ivec2( 1 ) ) ),
+	mMin( area.getUpperLeft() ), mScale( vec2( mSize ) / glm::max( area.getSize(), vec2( 1e-6f ) ) ), mCellSize( cellSize ), mInvCellSize( 1.0f / cellSize )
+	{
+		// summed area table of the texels inside the mask
+		std::vector<uint32_t> summedArea( ( mSize.x + 1 ) * ( mSize.y + 1 ), 0 );
+		for( int y = 0; y < mSize.y; y++ ) {
+			uint32_t rowSum = 0;
+			for( int x = 0; x < mSize.x; x++ ) {
+				rowSum += isTexelInside( ivec2( x, y ) ) ? 1 : 0;
+				summedArea[( x + 1 ) + ( y + 1 ) * ( mSize.x + 1 )] = summedArea[( x + 1 ) + y * ( mSize.x + 1 )] + rowSum;
+			}
+		}
 		
-		// spawn k points in an anulus around that point
-		// the higher k is, the higher the packing will be and slower the algorithm
-		for( int i = 0; i < k; i++ ){
-			float randRadius	= dist * ( 1.0f + randFloat() );
-			float randAngle		= randFloat() * M_PI * 2.0f;
-			vec2 newPoint		= center + vec2( cos( randAngle ), sin( randAngle ) ) * randRadius;
-			
-			// check if the new random point is in the window bounds
-			// and if it has no neighbors that are too close to them
-			if( bounds.contains( newPoint )
-			   && boundsFunction( newPoint )
-			   && !grid.hasNeighbors( newPoint, dist ) ){
-				
-				// if the point has no close neighbors add it to the processing list, output list and grid
-				processingList.push_back( newPoint );
-				outputList.push_back( newPoint );
-				grid.add( newPoint );
+		// classify the cells from the texels they overlap, the lookups of their points never read outside of that range
+		mNumCells = glm::max( ivec2( glm::ceil( area.getSize() * mInvCellSize ) ), ivec2( 1 ) );
+		mCellStates.resize( mNumCells.x * mNumCells.y );
+		for( int y = 0; y < mNumCells.y; y++ ) {
+			for( int x = 0; x < mNumCells.x; x++ ) {
+				ivec2 minTexel	= getTexelCoords( mMin + vec2( x, y ) * mCellSize );
+				ivec2 maxTexel	= getTexelCoords( mMin + vec2( x + 1, y + 1 ) * mCellSize ) + ivec2( 1 );
+				uint32_t count	= summedArea[maxTexel.x + maxTexel.y * ( mSize.x + 1 )] - summedArea[minTexel.x + maxTexel.y * ( mSize.x + 1 )]
+								- summedArea[maxTexel.x + minTexel.y * ( mSize.x + 1 )] + summedArea[minTexel.x + minTexel.y * ( mSize.x + 1 )];
+				uint32_t numTexels = ( maxTexel.x - minTexel.x ) * ( maxTexel.y - minTexel.y );
+				mCellStates[x + y * mNumCells.x] = count == 0 ? CELL_OUTSIDE : count == numTexels ? CELL_INSIDE : CELL_EDGE;
+			}
+		}
+	}
+	
+	bool ChannelMask::getCellPoint( const ivec2 &coords, vec2 *p ) const
+	{
+		uint8_t state = mCellStates[coords.x + coords.y * mNumCells.x];
+		if( state == CELL_INSIDE ) {
+			*p = mMin + ( vec2( coords ) + vec2( 0.5f ) ) * mCellSize;
+			return true;
+		}
+		else if( state == CELL_EDGE ) {
+			// center of the first texel inside the mask that is also inside the cell
+			vec2 cellMin	= mMin + vec2( coords ) * mCellSize;
+			ivec2 minTexel	= getTexelCoords( cellMin );
+			ivec2 maxTexel	= getTexelCoords( cellMin + vec2( mCellSize ) );
+			for( int y = minTexel.y; y <= maxTexel.y; y++ ) {
+				for( int x = minTexel.x; x <= maxTexel.x; x++ ) {
+					vec2 center = mMin + ( vec2( x, y ) + vec2( 0.5f ) ) / mScale;
+					if( isTexelInside( ivec2( x, y ) ) && getCellCoords( center ) == coords ) {
+						*p = center;
+						return true;
+					}
+				}
 			}
 		}
+		return false;
 	}
 	
-	return outputList;
+	namespace {
+		//! ranks the cells of the \a size wide node at \a origin in Z-order, skipping the ones outside of the grid
+		void rankMortonCells( const ivec3 &origin, int size, const ivec3 &numCells, int numChildren, uint32_t *rank, std::vector<uint32_t> *ranks )
+		{
+			if( origin.x >= numCells.x || origin.y >= numCells.y || origin.z >= numCells.z ) {
+				return;
+			}
+			if( size == 1 ) {
+				(*ranks)[origin.x + ( origin.y + origin.z * static_cast<size_t>( numCells.y ) ) * numCells.x] = (*rank)++;
+				return;
+			}
+			int half = size / 2;
+			for( int child = 0; child < numChildren; child++ ) {
+				rankMortonCells( origin + ivec3( child & 1, ( child >> 1 ) & 1, ( child >> 2 ) & 1 ) * half, half, numCells, numChildren, rank, ranks );
+			}
+		}
+		
+		//! ranks the cells of the node spanned by \a axisA and \a axisB from its \a origin corner along a Hilbert curve, skipping the ones outside of the grid
+		void rankHilbertCells( const ivec2 &origin, const ivec2 &axisA, const ivec2 &axisB, const ivec3 &numCells, uint32_t *rank, std::vector<uint32_t> *ranks )
+		{
+			ivec2 cell = glm::min( origin, origin + axisA + axisB );
+			if( cell.x >= numCells.x || cell.y >= numCells.y ) {
+				return;
+			}
+			if( glm::abs( axisA.x + axisA.y ) == 1 ) {
+				(*ranks)[cell.x + cell.y * static_cast<size_t>( numCells.x )] = (*rank)++;
+				return;
+			}
+			// the four quadrants of the U-shaped pattern, the first and last ones being transposed
+			ivec2 halfA = axisA / 2, halfB = axisB / 2;
+			rankHilbertCells( origin, halfB, halfA, numCells, rank, ranks );
+			rankHilbertCells( origin + halfA, halfA, halfB, numCells, rank, ranks );
+			rankHilbertCells( origin + halfA + halfB, halfA, halfB, numCells, rank, ranks );
+			rankHilbertCells( origin + halfA + axisB, -halfB, -halfA, numCells, rank, ranks );
+		}
+		
+		//! returns the distance along a 3D Hilbert curve of \a numBits per axis of \a cell, from Skilling's transpose
+		uint64_t getHilbertDistance( const ivec3 &cell, int numBits )
+		{
+			uint32_t x[3] = { static_cast<uint32_t>( cell.x ), static_cast<uint32_t>( cell.y ), static_cast<uint32_t>( cell.z ) };
+			for( uint32_t q = 1u << ( numBits - 1 ); q > 1; q >>= 1 ) {
+				uint32_t p = q - 1;
+				for( int i = 0; i < 3; i++ ) {
+					if( x[i] & q ) {
+						x[0] ^= p;
+					}
+					else {
+						uint32_t t = ( x[0] ^ x[i] ) & p;
+						x[0] ^= t;
+						x[i] ^= t;
+					}
+				}
+			}
+			x[1] ^= x[0];
+			x[2] ^= x[1];
+			uint32_t t = 0;
+			for( uint32_t q = 1u << ( numBits - 1 ); q > 1; q >>= 1 ) {
+				if( x[2] & q ) {
+					t ^= q - 1;
+				}
+			}
+			uint64_t distance = 0;
+			for( int bit = numBits - 1; bit >= 0; bit-- ) {
+				for( int i = 0; i < 3; i++ ) {
+					distance = ( distance << 1 ) | ( ( ( x[i] ^ t ) >> bit ) & 1 );
+				}
+			}
+			return distance;
+		}
+	}
+	
+	void getCurveRanks( const ivec3 &numCells, PoissonDiskOptions::Order order, std::vector<uint32_t> *ranks )
+	{
+		ranks->resize( static_cast<size_t>( numCells.x ) * numCells.y * numCells.z );
+		int size = 1, numBits = 1;
+		while( size < glm::max( numCells.x, glm::max( numCells.y, numCells.z ) ) ) {
+			size *= 2;
+			numBits++;
+		}
+		
+		uint32_t rank = 0;
+		if( order == PoissonDiskOptions::HILBERT_ORDER && numCells.z == 1 ) {
+			rankHilbertCells( ivec2( 0 ), ivec2( size, 0 ), ivec2( 0, size ), numCells, &rank, ranks );
+		}
+		else if( order == PoissonDiskOptions::HILBERT_ORDER ) {
+			// there's no simple recursive 3D construction, the cells are sorted by distance along the curve instead
+			std::vector<std::pair<uint64_t, uint32_t>> distances;
+			distances.reserve( ranks->size() );
+			for( int z = 0; z < numCells.z; z++ ) {
+				for( int y = 0; y < numCells.y; y++ ) {
+					for( int x = 0; x < numCells.x; x++ ) {
+						distances.emplace_back( getHilbertDistance( ivec3( x, y, z ), numBits ), static_cast<uint32_t>( distances.size() ) );
+					}
+				}
+			}
+			std::sort( distances.begin(), distances.end() );
+			for( const auto &distance : distances ) {
+				(*ranks)[distance.second] = rank++;
+			}
+		}
+		else {
+			rankMortonCells( ivec3( 0 ), size, numCells, numCells.z == 1 ? 4 : 8, &rank, ranks );
+		}
+	}
+	
+	uint32_t getSeed( const PoissonDiskOptions &options )
+	{
+		return options.hasSeed() ? options.getSeed() : std::random_device()();
+	}
+} // namespace poisson_detail
+
+PoissonDiskStats& PoissonDiskStats::operator+=( const PoissonDiskStats &other )
+{
+	mNumCandidates					+= other.mNumCandidates;
+	mNumOutOfBounds					+= other.mNumOutOfBounds;
+	mNumRejectedByBoundsFunction	+= other.mNumRejectedByBoundsFunction;
+	mNumRejectedByNeighbors			+= other.mNumRejectedByNeighbors;
+	mNumAccepted					+= other.mNumAccepted;
+	mNumNeighborQueries				+= other.mNumNeighborQueries;
+	mNumCellsVisited				+= other.mNumCellsVisited;
+	mNumPointsCompared				+= other.mNumPointsCompared;
+	mPeakActiveListSize				= std::max( mPeakActiveListSize, other.mPeakActiveListSize );
+	mSetupTime						+= other.mSetupTime;
+	mSamplingTime					+= other.mSamplingTime;
+	mOutputTime						+= other.mOutputTime;
+	return *this;
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( separation, bounds, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	vec2 range = getSeparationRange( distFunction, bounds, options );
+	return poissonDiskDistribution( distFunction, range.x, range.y, bounds, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( distFunction, minSeparation, maxSeparation, bounds, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	vec2 range = getSeparationRange( distFunction, bounds, options );
+	return poissonDiskDistribution( distFunction, range.x, range.y, boundsFunction, bounds, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const ci::Channel32f &density, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( ChannelSeparation( density, area, minSeparation, maxSeparation ), minSeparation, maxSeparation, area, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Channel8u &mask, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( ConstantSeparation{ separation }, separation, separation, ChannelMask( mask, area, separation ), area, initialSet, options );
+}
+
+std::vector<glm::vec2> poissonDiskDistribution( const ci::Channel32f &density, float minSeparation, float maxSeparation, const ci::Channel8u &mask, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( ChannelSeparation( density, area, minSeparation, maxSeparation ), minSeparation, maxSeparation, ChannelMask( mask, area, maxSeparation ), area, initialSet, options );
+}
+
+void poissonDiskDistributionBatch( const PoissonDiskJob *jobs, size_t count, std::vector<glm::vec2> *output, std::vector<uint32_t> *offsets, const PoissonDiskOptions &options )
+{
+	poissonDiskDistributionBatch( [jobs]( size_t i, const vec2 & ) { return jobs[i].mMinSeparation; }, jobs, count, output, offsets, options );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( separation, bounds, initialSet, options );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	vec2 range = getSeparationRange( distFunction, bounds, options );
+	return poissonDiskDistribution( distFunction, range.x, range.y, bounds, initialSet, options );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( distFunction, minSeparation, maxSeparation, bounds, initialSet, options );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	vec2 range = getSeparationRange( distFunction, bounds, options );
+	return poissonDiskDistribution( distFunction, range.x, range.y, boundsFunction, bounds, initialSet, options );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poissonDiskDistribution<PoissonDiskRandom>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options );
+}
+
+namespace {
+	//! triangle of a mesh with its frame, to spawn candidates in its plane, and its barycentric terms, to test whether they're inside
+	struct MeshTriangle {
+		vec3	mA, mEdge0, mEdge1;
+		vec3	mTangent, mBitangent;
+		float	mD00, mD01, mD11, mInvDenom;
+		float	mArea;
+	};
+	
+	//! returns the point of the triangle \a a, \a b, \a c closest to \a p, from Ericson's Real-Time Collision Detection
+	vec3 getClosestPointOnTriangle( const vec3 &p, const vec3 &a, const vec3 &b, const vec3 &c )
+	{
+		vec3 ab = b - a, ac = c - a, ap = p - a;
+		float d1 = glm::dot( ab, ap ), d2 = glm::dot( ac, ap );
+		if( d1 <= 0.0f && d2 <= 0.0f ) {
+			return a;
+		}
+		vec3 bp = p - b;
+		float d3 = glm::dot( ab, bp ), d4 = glm::dot( ac, bp );
+		if( d3 >= 0.0f && d4 <= d3 ) {
+			return b;
+		}
+		float vc = d1 * d4 - d3 * d2;
+		if( vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f ) {
+			return a + ab * ( d1 / ( d1 - d3 ) );
+		}
+		vec3 cp = p - c;
+		float d5 = glm::dot( ab, cp ), d6 = glm::dot( ac, cp );
+		if( d6 >= 0.0f && d5 <= d6 ) {
+			return c;
+		}
+		float vb = d5 * d2 - d1 * d6;
+		if( vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f ) {
+			return a + ac * ( d2 / ( d2 - d6 ) );
+		}
+		float va = d3 * d6 - d5 * d4;
+		if( va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f ) {
+			return b + ( c - b ) * ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) );
+		}
+		float invSum = 1.0f / ( va + vb + vc );
+		return a + ab * ( vb * invSum ) + ac * ( vc * invSum );
+	}
+	
+	//! Triangles of a mesh bucketed in the cells of a sparse grid, to project the candidates that leave their triangle back on the surface
+	class MeshSurface {
+	public:
+		MeshSurface( const ci::TriMesh &mesh, float cellSize );
+		
+		//! returns whether \a p, in the plane of \a triangle, is inside of it
+		bool isInside( uint32_t triangle, const vec3 &p ) const;
+		//! moves \a p to the closest point of the triangles around it and returns whether that point was closer than \a maxDistance, which has to be at most half a cell
+		bool project( vec3 *p, uint32_t *triangle, float maxDistance ) const;
+		//! returns a random point of \a triangle
+		template<typename URBG>
+		vec3 randPoint( URBG &rng, uint32_t triangle ) const
+		{
+			const MeshTriangle &t = mTriangles[triangle];
+			float u = randFloat( rng ), v = randFloat( rng );
+			if( u + v > 1.0f ) {
+				u = 1.0f - u;
+				v = 1.0f - v;
+			}
+			return t.mA + t.mEdge0 * u + t.mEdge1 * v;
+		}
+		
+		//! returns the triangles of the mesh
+		const std::vector<MeshTriangle>& getTriangles() const { return mTriangles; }
+		//! returns the bounding box of the mesh
+		const ci::AxisAlignedBox& getBounds() const { return mBounds; }
+		
+	protected:
+		ivec3 getCellCoords( const vec3 &p ) const { return glm::clamp( ivec3( glm::floor( ( p - mMin ) * mInvCellSize ) ), ivec3( 0 ), ivec3( kMaxCoord ) ); }
+		static uint64_t getCellKey( const ivec3 &cell ) { return static_cast<uint64_t>( cell.x ) | static_cast<uint64_t>( cell.y ) << 21 | static_cast<uint64_t>( cell.z ) << 42; }
+		
+		static const int kMaxCoord = ( 1 << 21 ) - 1;
+		
+		std::vector<MeshTriangle>					mTriangles;
+		std::vector<std::pair<uint64_t, uint32_t>>	mCells; // ( cell key, triangle index ) pairs sorted by cell
+		ci::AxisAlignedBox							mBounds;
+		vec3										mMin;
+		float										mCellSize, mInvCellSize;
+	};
+	
+	MeshSurface::MeshSurface( const ci::TriMesh &mesh, float cellSize )
+	: mCellSize( cellSize ), mInvCellSize( 1.0f / cellSize )
+	{
+		vec3 min( numeric_limits<float>::max() ), max( -numeric_limits<float>::max() );
+		mTriangles.resize( mesh.getNumTriangles() );
+		for( size_t i = 0; i < mTriangles.size(); i++ ) {
+			vec3 a, b, c;
+			mesh.getTriangleVertices( i, &a, &b, &c );
+			MeshTriangle &t	= mTriangles[i];
+			t.mA			= a;
+			t.mEdge0		= b - a;
+			t.mEdge1		= c - a;
+			vec3 normal		= glm::cross( t.mEdge0, t.mEdge1 );
+			t.mArea			= 0.5f * glm::length( normal );
+			if( t.mArea > 0.0f ) {
+				t.mTangent		= glm::normalize( t.mEdge0 );
+				t.mBitangent	= glm::normalize( glm::cross( normal, t.mEdge0 ) );
+				t.mD00			= glm::dot( t.mEdge0, t.mEdge0 );
+				t.mD01			= glm::dot( t.mEdge0, t.mEdge1 );
+				t.mD11			= glm::dot( t.mEdge1, t.mEdge1 );
+				t.mInvDenom		= 1.0f / ( t.mD00 * t.mD11 - t.mD01 * t.mD01 );
+			}
+			min = glm::min( min, glm::min( a, glm::min( b, c ) ) );
+			max = glm::max( max, glm::max( a, glm::max( b, c ) ) );
+		}
+		if( mTriangles.empty() ) {
+			return;
+		}
+		mBounds	= ci::AxisAlignedBox( min, max );
+		mMin	= min - vec3( cellSize );
+		
+		// register each triangle in the cells of a lattice of points spaced by at most half a cell. Every point of the triangle is then within half a cell of the lattice, and any point within half a cell of the triangle finds it in the cells around its own. The lattice is made of columns perpendicular to the longest edge, each one as tall as the triangle around it, so that slivers only register the cells along them.
+		const float spacing = 0.5f * cellSize;
+		std::vector<uint64_t> keys;
+		for( uint32_t i = 0; i < mTriangles.size(); i++ ) {
+			const MeshTriangle &t = mTriangles[i];
+			if( t.mArea <= 0.0f ) {
+				continue;
+			}
+			// the longest edge is the base, the apex projects inside of it
+			vec3 corners[3]	= { t.mA, t.mA + t.mEdge0, t.mA + t.mEdge1 };
+			int base		= 0;
+			for( int j = 1; j < 3; j++ ) {
+				if( glm::length2( corners[( j + 1 ) % 3] - corners[j] ) > glm::length2( corners[( base + 1 ) % 3] - corners[base] ) ) {
+					base = j;
+				}
+			}
+			vec3 origin		= corners[base];
+			vec3 apex		= corners[( base + 2 ) % 3];
+			float length	= glm::length( corners[( base + 1 ) % 3] - origin );
+			vec3 direction	= ( corners[( base + 1 ) % 3] - origin ) / length;
+			float foot		= glm::clamp( glm::dot( apex - origin, direction ), 0.0f, length );
+			vec3 up			= apex - origin - direction * foot;
+			float height	= glm::length( up );
+			up				= height > 0.0f ? up / height : vec3( 0.0f );
+			auto getHeight = [&]( float x ) {
+				return x <= foot ? ( foot > 0.0f ? height * x / foot : height ) : height * ( length - x ) / ( length - foot );
+			};
+			
+			int numColumns		= glm::max( static_cast<int>( std::ceil( length / spacing ) ), 1 );
+			float columnSpacing	= length / numColumns;
+			keys.clear();
+			for( int u = 0; u <= numColumns; u++ ) {
+				// the column covers the tallest part of the triangle within half a column of it
+				float x			= glm::min( u * columnSpacing, length );
+				float top		= getHeight( glm::clamp( foot, x - 0.5f * columnSpacing, x + 0.5f * columnSpacing ) );
+				int numRows		= glm::max( static_cast<int>( std::ceil( top / spacing ) ), 1 );
+				for( int v = 0; v <= numRows; v++ ) {
+					keys.push_back( getCellKey( getCellCoords( origin + direction * x + up * ( top * v / numRows ) ) ) );
+				}
+			}
+			sort( keys.begin(), keys.end() );
+			keys.erase( unique( keys.begin(), keys.end() ), keys.end() );
+			for( uint64_t key : keys ) {
+				mCells.emplace_back( key, i );
+			}
+		}
+		sort( mCells.begin(), mCells.end() );
+	}
+	
+	bool MeshSurface::isInside( uint32_t triangle, const vec3 &p ) const
+	{
+		const MeshTriangle &t = mTriangles[triangle];
+		vec3 d	= p - t.mA;
+		float d20	= glm::dot( d, t.mEdge0 );
+		float d21	= glm::dot( d, t.mEdge1 );
+		float v		= ( t.mD11 * d20 - t.mD01 * d21 ) * t.mInvDenom;
+		float w		= ( t.mD00 * d21 - t.mD01 * d20 ) * t.mInvDenom;
+		return v >= 0.0f && w >= 0.0f && v + w <= 1.0f;
+	}
+	
+	bool MeshSurface::project( vec3 *p, uint32_t *triangle, float maxDistance ) const
+	{
+		float nearestDist2	= maxDistance * maxDistance;
+		bool found			= false;
+		vec3 nearest( 0.0f );
+		auto visitCell = [&]( const ivec3 &cell ) {
+			uint64_t key = getCellKey( cell );
+			auto it = lower_bound( mCells.begin(), mCells.end(), key, []( const std::pair<uint64_t, uint32_t> &entry, uint64_t k ) { return entry.first < k; } );
+			for( ; it != mCells.end() && it->first == key; ++it ) {
+				const MeshTriangle &t	= mTriangles[it->second];
+				vec3 q					= getClosestPointOnTriangle( *p, t.mA, t.mA + t.mEdge0, t.mA + t.mEdge1 );
+				float dist2				= glm::length2( q - *p );
+				if( dist2 < nearestDist2 ) {
+					nearestDist2	= dist2;
+					nearest			= q;
+					*triangle		= it->second;
+					found			= true;
+				}
+			}
+		};
+		
+		// a closer triangle can be registered in the cells around the one of the point, like the other side of a thin wall, all of them are visited to find the nearest one
+		ivec3 cell		= getCellCoords( *p );
+		ivec3 minCell	= glm::max( cell - ivec3( 1 ), ivec3( 0 ) );
+		ivec3 maxCell	= glm::min( cell + ivec3( 1 ), ivec3( kMaxCoord ) );
+		for( int z = minCell.z; z <= maxCell.z; z++ ) {
+			for( int y = minCell.y; y <= maxCell.y; y++ ) {
+				for( int x = minCell.x; x <= maxCell.x; x++ ) {
+					visitCell( ivec3( x, y, z ) );
+				}
+			}
+		}
+		if( found ) {
+			*p = nearest;
+		}
+		return found;
+	}
+	
+	//! Bridson's algorithm on the surface of a mesh. Every triangle throws a number of darts proportional to its area, and each accepted dart grows a front over the surface, so that disconnected parts and regions the fronts couldn't reach are covered too.
+	template<typename GridT, typename DistFn>
+	std::vector<vec3> sampleMesh( GridT &grid, const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::TriMesh &mesh, const PoissonDiskOptions &options, std::vector<uint32_t> *triangleIndices )
+	{
+		POISSON_DISK_STAT( PoissonDiskStats stats; )
+		POISSON_DISK_STAT( double startTime = getTime(); )
+		SamplingBudget budget( options );
+		// the projections only hold for separations in the range
+		auto clampedDistFunction = [&]( const vec3 &p ) { return glm::clamp( distFunction( p ), minSeparation, maxSeparation ); };
+		
+		// projections are at most half a separation away, which has to be at most half a cell of the surface grid
+		MeshSurface surface( mesh, maxSeparation );
+		std::vector<uint32_t> triangles; // triangle of each point
+		if( triangleIndices ) {
+			triangleIndices->clear();
+		}
+		if( surface.getTriangles().empty() ) {
+			return std::vector<vec3>();
+		}
+		setupGrid( grid, ci::AxisAlignedBox( surface.getBounds().getMin() - vec3( maxSeparation ), surface.getBounds().getMax() + vec3( maxSeparation ) ), minSeparation, maxSeparation );
+		POISSON_DISK_STAT( grid.setStats( options.getStats() ? &stats : nullptr ); )
+		POISSON_DISK_STAT( stats.mSetupTime = getTime() - startTime; )
+		POISSON_DISK_STAT( startTime = getTime(); )
+		
+		PoissonDiskRandom rng( getSeed( options ) );
+		std::vector<int32_t> processingList;
+		bool isFull = false;
+		auto tryAdd = [&]( const vec3 &p, uint32_t triangle, float dist ) {
+			if( grid.hasNeighbors( p, dist ) ) {
+				POISSON_DISK_STAT( stats.mNumRejectedByNeighbors++; )
+				return;
+			}
+			if( ! budget.addPoint() ) {
+				isFull = true;
+				return;
+			}
+			processingList.push_back( grid.add( p ) );
+			triangles.push_back( triangle );
+			POISSON_DISK_STAT( stats.mNumAccepted++; )
+			POISSON_DISK_STAT( stats.mPeakActiveListSize = glm::max( stats.mPeakActiveListSize, processingList.size() ); )
+		};
+		
+		const std::vector<MeshTriangle> &meshTriangles = surface.getTriangles();
+		for( uint32_t i = 0; i < meshTriangles.size() && ! isFull && ! budget.isExhausted(); i++ ) {
+			const MeshTriangle &triangle	= meshTriangles[i];
+			// the separation can't go below the minimum, and huge triangles of tiny separations are capped to what fits an int before the cast
+			float centroidDist				= clampedDistFunction( triangle.mA + ( triangle.mEdge0 + triangle.mEdge1 ) / 3.0f );
+			double maxDarts					= static_cast<double>( std::ceil( static_cast<double>( triangle.mArea ) / ( static_cast<double>( centroidDist ) * centroidDist ) ) );
+			int numDarts					= static_cast<int>( glm::min( maxDarts, static_cast<double>( numeric_limits<int>::max() ) ) );
+			for( int dart = 0; dart < numDarts && ! isFull && ! budget.isExhausted(); dart++ ) {
+				vec3 p = surface.randPoint( rng, i );
+				POISSON_DISK_STAT( stats.mNumCandidates++; )
+				tryAdd( p, i, clampedDistFunction( p ) );
+				
+				// grow the front of the accepted dart, candidates that leave the plane of their triangle are projected on the closest one
+				while( processingList.size() && ! isFull && ! budget.isExhausted() ) {
+					int randPoint = randInt( rng, processingList.size() );
+					int32_t index = processingList[randPoint];
+					processingList[randPoint] = processingList.back();
+					processingList.pop_back();
+					
+					vec3 center					= grid.getPoint( index );
+					uint32_t centerTriangle		= triangles[index];
+					const MeshTriangle &plane	= meshTriangles[centerTriangle];
+					float dist					= clampedDistFunction( center );
+					DirectionRotation<vec2> rotation;
+					if( options.getCandidateMode() == PoissonDiskOptions::DIRECTION_TABLE ) {
+						rotation = randDirectionRotation( rng, vec2( 0.0f ) );
+					}
+					for( int k = 0; k < options.getK() && ! isFull; k++ ) {
+						vec2 offset				= randAnnulusPoint( rng, vec2( 0.0f ), dist, rotation, options.getCandidateMode() );
+						vec3 candidate			= center + plane.mTangent * offset.x + plane.mBitangent * offset.y;
+						uint32_t candidateTriangle = centerTriangle;
+						POISSON_DISK_STAT( stats.mNumCandidates++; )
+						if( ! surface.isInside( centerTriangle, candidate ) && ! surface.project( &candidate, &candidateTriangle, 0.5f * dist ) ) {
+							POISSON_DISK_STAT( stats.mNumOutOfBounds++; )
+							continue;
+						}
+						tryAdd( candidate, candidateTriangle, dist );
+					}
+				}
+			}
+		}
+		
+		POISSON_DISK_STAT( grid.setStats( nullptr ); )
+		POISSON_DISK_STAT( stats.mSamplingTime = getTime() - startTime; )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+		if( triangleIndices ) {
+			triangleIndices->swap( triangles );
+		}
+		return grid.releasePoints();
+	}
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::TriMesh &mesh, const PoissonDiskOptions &options, std::vector<uint32_t> *triangleIndices )
+{
+	Grid<vec3> grid;
+	return sampleMesh( grid, ConstantSeparation{ separation }, separation, separation, mesh, options, triangleIndices );
+}
+
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::TriMesh &mesh, const PoissonDiskOptions &options, std::vector<uint32_t> *triangleIndices )
+{
+	if( isMultiLevel( minSeparation, maxSeparation ) ) {
+		MultiLevelGrid<vec3> grid;
+		return sampleMesh( grid, distFunction, minSeparation, maxSeparation, mesh, options, triangleIndices );
+	}
+	Grid<vec3> grid;
+	return sampleMesh( grid, distFunction, minSeparation, maxSeparation, mesh, options, triangleIndices );
+}
+
+namespace {
+	//! Binary max-heap of point indices ordered by weight, which keeps the position of each point so that its weight can be lowered in place. Weights are stored next to the indices so that sifting doesn't jump around memory.
+	class EliminationHeap {
+	public:
+		explicit EliminationHeap( const std::vector<float> &weights )
+		: mHeap( weights.size() ), mPositions( weights.size() )
+		{
+			for( size_t i = 0; i < mHeap.size(); i++ ) {
+				mHeap[i]		= Entry{ weights[i], static_cast<int32_t>( i ) };
+				mPositions[i]	= static_cast<uint32_t>( i );
+			}
+			for( size_t i = mHeap.size() / 2; i-- > 0; ) {
+				siftDown( i );
+			}
+		}
+		
+		//! removes and returns the point with the highest weight
+		int32_t pop()
+		{
+			int32_t top	= mHeap.front().mIndex;
+			mHeap.front() = mHeap.back();
+			mPositions[mHeap.front().mIndex] = 0;
+			mHeap.pop_back();
+			if( ! mHeap.empty() ) {
+				siftDown( 0 );
+			}
+			return top;
+		}
+		//! lowers the weight of \a index by \a amount
+		void decrease( int32_t index, float amount )
+		{
+			uint32_t position = mPositions[index];
+			mHeap[position].mWeight -= amount;
+			siftDown( position );
+		}
+		
+		size_t size() const { return mHeap.size(); }
+		
+	protected:
+		struct Entry {
+			float	mWeight;
+			int32_t	mIndex;
+		};
+		
+		void siftDown( size_t position )
+		{
+			Entry entry = mHeap[position];
+			while( true ) {
+				size_t child = 2 * position + 1;
+				if( child >= mHeap.size() ) {
+					break;
+				}
+				if( child + 1 < mHeap.size() && mHeap[child + 1].mWeight > mHeap[child].mWeight ) {
+					child++;
+				}
+				if( mHeap[child].mWeight <= entry.mWeight ) {
+					break;
+				}
+				mHeap[position] = mHeap[child];
+				mPositions[mHeap[position].mIndex] = static_cast<uint32_t>( position );
+				position = child;
+			}
+			mHeap[position] = entry;
+			mPositions[entry.mIndex] = static_cast<uint32_t>( position );
+		}
+		
+		std::vector<Entry>		mHeap;
+		std::vector<uint32_t>	mPositions;
+	};
+	
+	//! returns the volume of \a bounds over the axes that have an extent
+	float getVolume( const ci::Rectf &bounds ) { return glm::max( bounds.getWidth(), 1e-6f ) * glm::max( bounds.getHeight(), 1e-6f ); }
+	float getVolume( const ci::AxisAlignedBox &bounds ) { vec3 size = glm::max( bounds.getSize(), vec3( 1e-6f ) ); return size.x * size.y * size.z; }
+	
+	template<typename VecT>
+	std::vector<VecT> eliminateSamples( std::vector<VecT> points, size_t numPoints, const typename GridTraits<VecT>::BoundsT &bounds )
+	{
+		if( ! numPoints ) {
+			return std::vector<VecT>();
+		}
+		
+		// neighboring points close in memory make the grid, the neighbor lists and the heap much more cache friendly
+		sortAlongCurve( &points, PoissonDiskOptions::HILBERT_ORDER );
+		if( numPoints >= points.size() ) {
+			return points;
+		}
+		
+		// radius of the densest packing of numPoints disks or spheres, and the distance under which the paper limits the weights
+		const int kDimensions	= GridTraits<VecT>::kDimensions;
+		float volume			= getVolume( bounds );
+		float maxRadius			= kDimensions == 2 ? std::sqrt( volume / ( 2.0f * std::sqrt( 3.0f ) * numPoints ) ) : std::cbrt( volume / ( 4.0f * std::sqrt( 2.0f ) * numPoints ) );
+		float diameter			= 2.0f * maxRadius;
+		float minDistance		= diameter * ( 1.0f - std::pow( numPoints / static_cast<float>( points.size() ), 1.5f ) ) * 0.65f;
+		
+		// cells of a diameter hold about oversampling points each
+		float expectedPerCell	= points.size() * std::pow( diameter, static_cast<float>( kDimensions ) ) / volume;
+		Grid<VecT> grid( bounds, diameter, static_cast<uint32_t>( std::ceil( 2.0f * expectedPerCell ) ) + 1 );
+		grid.reserve( points.size() );
+		for( const auto &p : points ) {
+			grid.add( p );
+		}
+		
+		// the weight of a point is the sum of ( 1 - d / 2r )^8 over the neighbors closer than 2r, with d limited to minDistance. Each pair is found once and stored for both points.
+		std::vector<std::pair<int32_t, int32_t>> pairs;
+		std::vector<float> pairWeights;
+		std::vector<uint32_t> offsets( points.size() + 1, 0 );
+		std::vector<float> weights( points.size(), 0.0f );
+		std::vector<int32_t> candidates;
+		for( size_t i = 0; i < points.size(); i++ ) {
+			candidates.clear();
+			grid.getPointsInCells( points[i] - VecT( diameter ), points[i] + VecT( diameter ), &candidates );
+			for( int32_t j : candidates ) {
+				if( j <= static_cast<int32_t>( i ) ) {
+					continue;
+				}
+				float dist = glm::distance( points[i], points[j] );
+				if( dist < diameter ) {
+					float w = 1.0f - glm::max( dist, minDistance ) / diameter;
+					w *= w;
+					w *= w;
+					w *= w;
+					pairs.emplace_back( static_cast<int32_t>( i ), j );
+					pairWeights.push_back( w );
+					weights[i] += w;
+					weights[j] += w;
+					offsets[i + 1]++;
+					offsets[j + 1]++;
+				}
+			}
+		}
+		for( size_t i = 1; i < offsets.size(); i++ ) {
+			offsets[i] += offsets[i - 1];
+		}
+		std::vector<int32_t> neighbors( offsets.back() );
+		std::vector<float> neighborWeights( offsets.back() );
+		std::vector<uint32_t> fill( offsets.begin(), offsets.end() - 1 );
+		for( size_t n = 0; n < pairs.size(); n++ ) {
+			uint32_t a = fill[pairs[n].first]++, b = fill[pairs[n].second]++;
+			neighbors[a]		= pairs[n].second;
+			neighborWeights[a]	= pairWeights[n];
+			neighbors[b]		= pairs[n].first;
+			neighborWeights[b]	= pairWeights[n];
+		}
+		
+		// remove the point with the highest weight and its contribution to its neighbors until numPoints remain
+		EliminationHeap heap( weights );
+		std::vector<bool> isRemoved( points.size(), false );
+		while( heap.size() > numPoints ) {
+			int32_t i = heap.pop();
+			isRemoved[i] = true;
+			for( uint32_t n = offsets[i]; n < offsets[i + 1]; n++ ) {
+				if( ! isRemoved[neighbors[n]] ) {
+					heap.decrease( neighbors[n], neighborWeights[n] );
+				}
+			}
+		}
+		
+		std::vector<VecT> result;
+		result.reserve( numPoints );
+		for( size_t i = 0; i < points.size(); i++ ) {
+			if( ! isRemoved[i] ) {
+				result.push_back( points[i] );
+			}
+		}
+		return result;
+	}
+	
+	template<typename VecT>
+	std::vector<VecT> sampleFixedCount( size_t numPoints, const typename GridTraits<VecT>::BoundsT &bounds, const PoissonDiskOptions &options, float oversampling )
+	{
+		PoissonDiskRandom rng( getSeed( options ) );
+		std::vector<VecT> points( static_cast<size_t>( std::ceil( numPoints * glm::max( oversampling, 1.0f ) ) ) );
+		for( auto &p : points ) {
+			p = randPoint( rng, bounds );
+		}
+		return eliminateSamples( std::move( points ), numPoints, bounds );
+	}
+}
+
+std::vector<glm::vec2> poissonDiskDistributionFixedCount( size_t numPoints, const ci::Rectf &area, const PoissonDiskOptions &options, float oversampling )
+{
+	return sampleFixedCount<vec2>( numPoints, area, options, oversampling );
+}
+
+std::vector<glm::vec3> poissonDiskDistributionFixedCount( size_t numPoints, const ci::AxisAlignedBox &bounds, const PoissonDiskOptions &options, float oversampling )
+{
+	return sampleFixedCount<vec3>( numPoints, bounds, options, oversampling );
+}
+
+std::vector<glm::vec2> poissonDiskElimination( const std::vector<glm::vec2> &points, size_t numPoints, const ci::Rectf &area )
+{
+	return eliminateSamples( points, numPoints, area );
+}
+
+std::vector<glm::vec3> poissonDiskElimination( const std::vector<glm::vec3> &points, size_t numPoints, const ci::AxisAlignedBox &bounds )
+{
+	return eliminateSamples( points, numPoints, bounds );
+}
+
+namespace {
+	template<typename VecT>
+	std::vector<typename poisson_detail::GridTraits<VecT>::BoundsT> getChunkBounds( const std::vector<VecT> &points, size_t chunkSize )
+	{
+		chunkSize = std::max<size_t>( chunkSize, 1 );
+		std::vector<typename poisson_detail::GridTraits<VecT>::BoundsT> bounds;
+		bounds.reserve( ( points.size() + chunkSize - 1 ) / chunkSize );
+		for( size_t i = 0; i < points.size(); i += chunkSize ) {
+			VecT min = points[i], max = points[i];
+			for( size_t j = i + 1; j < std::min( i + chunkSize, points.size() ); j++ ) {
+				min = glm::min( min, points[j] );
+				max = glm::max( max, points[j] );
+			}
+			bounds.push_back( poisson_detail::makeBounds( min, max ) );
+		}
+		return bounds;
+	}
+}
+
+std::vector<ci::Rectf> poissonDiskChunkBounds( const std::vector<glm::vec2> &points, size_t chunkSize )
+{
+	return getChunkBounds( points, chunkSize );
+}
+
+std::vector<ci::AxisAlignedBox> poissonDiskChunkBounds( const std::vector<glm::vec3> &points, size_t chunkSize )
+{
+	return getChunkBounds( points, chunkSize );
+}
+
+PoissonDiskTileSet::PoissonDiskTileSet( float separation, float tileSize, size_t numTiles, const PoissonDiskOptions &options )
+: mSeparation( separation ), mTileSize( glm::max( tileSize, 4.0f * separation ) )
+{
+	const float size	= mTileSize;
+	const Rectf tile( 0.0f, 0.0f, size, size );
+	float cellSize		= getCellSize( separation, separation );
+	uint32_t seed		= getSeed( options );
+	ConstantSeparation distFunction{ separation };
+	// the budgets, minimum acceptance rate and adaptive k would leave holes in the tiles that every fill repeats, only the
+	// options shaping the packing are kept
+	PoissonDiskOptions tileOptions = PoissonDiskOptions().k( options.getK() ).candidateMode( options.getCandidateMode() ).seed( seed );
+	
+	// sample the base tile on a torus, each accepted point is also added to the grid
+	// at its periodic locations so that the tile matches itself across every edge
+	std::vector<vec2> base;
+	{
+		Rectf gridBounds( -separation, -separation, size + separation, size + separation );
+		Grid<vec2> grid( gridBounds, cellSize );
+		PoissonDiskRandom rng( hashSeed( seed, 0 ) );
+		auto addPoint = [&]( const vec2 &p ) {
+			base.push_back( p );
+			for( int y = -1; y <= 1; y++ ) {
+				for( int x = -1; x <= 1; x++ ) {
+					vec2 copy = p + vec2( x, y ) * size;
+					if( ( x || y ) && gridBounds.contains( copy ) ) {
+						grid.add( copy );
+					}
+				}
+			}
+		};
+		
+		std::vector<int32_t> processingList;
+		vec2 start = randPoint( rng, tile );
+		processingList.push_back( grid.add( start ) );
+		addPoint( start );
+		SamplingBudget budget( tileOptions );
+		processActiveList( grid, processingList, rng, distFunction, NoBoundsFunction(), tile, tileOptions, budget, [&]( int32_t index ) {
+			addPoint( grid.getPoint( index ) );
+		} );
+	}
+	
+	// the points closer to the edges than the separation form the border shared by all the tiles
+	std::vector<vec2> border;
+	for( const auto &p : base ) {
+		if( glm::min( glm::min( p.x, p.y ), glm::min( size - p.x, size - p.y ) ) < separation ) {
+			border.push_back( p );
+		}
+	}
+	
+	// the first tile is the base tile, the other ones resample the interior from the border. Interior points
+	// are at least one separation away from the edges so they can't conflict with the neighboring tiles
+	mPoints = base;
+	mOffsets.push_back( 0 );
+	mOffsets.push_back( static_cast<uint32_t>( mPoints.size() ) );
+	Rectf interior( separation, separation, size - separation, size - separation );
+	Grid<vec2> grid;
+	std::vector<int32_t> processingList;
+	for( size_t i = 1; i < numTiles; i++ ) {
+		PoissonDiskRandom rng( hashSeed( seed, static_cast<uint32_t>( i ) ) );
+		grid.resize( tile, cellSize );
+		processingList.clear();
+		for( const auto &p : border ) {
+			processingList.push_back( grid.add( p ) );
+		}
+		
+		// start from the center if there's no border
+		if( processingList.empty() ) {
+			processingList.push_back( grid.add( interior.getCenter() ) );
+		}
+		SamplingBudget budget( tileOptions );
+		processActiveList( grid, processingList, rng, distFunction, NoBoundsFunction(), interior, tileOptions, budget, []( int32_t ) {} );
+		
+		mPoints.insert( mPoints.end(), grid.getPoints().begin(), grid.getPoints().end() );
+		mOffsets.push_back( static_cast<uint32_t>( mPoints.size() ) );
+	}
+}
+
+std::vector<glm::vec2> PoissonDiskTileSet::fill( const ci::Rectf &area, uint32_t seed ) const
+{
+	std::vector<glm::vec2> output;
+	fill( area, &output, seed );
+	return output;
+}
+
+void PoissonDiskTileSet::fill( const ci::Rectf &area, std::vector<glm::vec2> *output, uint32_t seed ) const
+{
+	size_t numTiles = getNumTiles();
+	if( ! numTiles || ! output ) {
+		return;
+	}
+	
+	vec2 areaMin	= glm::min( area.getUpperLeft(), area.getLowerRight() );
+	vec2 areaMax	= glm::max( area.getUpperLeft(), area.getLowerRight() );
+	ivec2 first		= ivec2( glm::floor( areaMin / mTileSize ) );
+	ivec2 last		= ivec2( glm::ceil( areaMax / mTileSize ) );
+	
+	// reserve using the average density of the tiles
+	float density	= mPoints.size() / ( numTiles * mTileSize * mTileSize );
+	output->reserve( output->size() + static_cast<size_t>( ( areaMax.x - areaMin.x ) * ( areaMax.y - areaMin.y ) * density * 1.1f ) );
+	
+	for( int y = first.y; y < last.y; y++ ) {
+		for( int x = first.x; x < last.x; x++ ) {
+			uint32_t hash		= hashSeed( hashSeed( seed, static_cast<uint32_t>( x ) ), static_cast<uint32_t>( y ) );
+			size_t index		= hash % numTiles;
+			vec2 offset			= vec2( x, y ) * mTileSize;
+			const vec2 *begin	= getTilePoints( index );
+			const vec2 *end		= begin + getTileNumPoints( index );
+			
+			// tiles fully inside the area are copied as is, the others are clipped
+			if( offset.x >= areaMin.x && offset.y >= areaMin.y && offset.x + mTileSize < areaMax.x && offset.y + mTileSize < areaMax.y ) {
+				for( const vec2 *p = begin; p != end; ++p ) {
+					output->push_back( *p + offset );
+				}
+			}
+			else {
+				for( const vec2 *p = begin; p != end; ++p ) {
+					vec2 q = *p + offset;
+					if( q.x >= areaMin.x && q.y >= areaMin.y && q.x < areaMax.x && q.y < areaMax.y ) {
+						output->push_back( q );
+					}
+				}
+			}
+		}
+	}
+}
+
+namespace {
+	const uint32_t kTileSetMagic	= 0x53544450; // "PDTS"
+	const uint32_t kTileSetVersion	= 1;
+}
+
+void PoissonDiskTileSet::write( std::ostream &stream ) const
+{
+	uint32_t header[4] = { kTileSetMagic, kTileSetVersion, static_cast<uint32_t>( getNumTiles() ), static_cast<uint32_t>( mPoints.size() ) };
+	float sizes[2] = { mSeparation, mTileSize };
+	stream.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+	stream.write( reinterpret_cast<const char*>( sizes ), sizeof( sizes ) );
+	stream.write( reinterpret_cast<const char*>( mOffsets.data() ), mOffsets.size() * sizeof( uint32_t ) );
+	stream.write( reinterpret_cast<const char*>( mPoints.data() ), mPoints.size() * sizeof( vec2 ) );
+}
+
+PoissonDiskTileSet PoissonDiskTileSet::read( std::istream &stream )
+{
+	PoissonDiskTileSet tileSet;
+	uint32_t header[4];
+	float sizes[2];
+	if( ! stream.read( reinterpret_cast<char*>( header ), sizeof( header ) ) || header[0] != kTileSetMagic || header[1] != kTileSetVersion
+	   || ! stream.read( reinterpret_cast<char*>( sizes ), sizeof( sizes ) ) ) {
+		CI_LOG_E( "Invalid tile set" );
+		return tileSet;
+	}
+	
+	tileSet.mSeparation	= sizes[0];
+	tileSet.mTileSize	= sizes[1];
+	tileSet.mOffsets.resize( header[2] ? header[2] + 1 : 0 );
+	tileSet.mPoints.resize( header[3] );
+	if( ! stream.read( reinterpret_cast<char*>( tileSet.mOffsets.data() ), tileSet.mOffsets.size() * sizeof( uint32_t ) )
+	   || ! stream.read( reinterpret_cast<char*>( tileSet.mPoints.data() ), tileSet.mPoints.size() * sizeof( vec2 ) )
+	   || ( ! tileSet.mOffsets.empty() && ( tileSet.mOffsets.front() != 0 || tileSet.mOffsets.back() != tileSet.mPoints.size() || ! is_sorted( tileSet.mOffsets.begin(), tileSet.mOffsets.end() ) ) ) ) {
+		CI_LOG_E( "Truncated tile set" );
+		return PoissonDiskTileSet();
+	}
+	return tileSet;
+}
+
+PoissonDiskChunkSampler::PoissonDiskChunkSampler( float separation, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options )
+: PoissonDiskChunkSampler( nullptr, separation, separation, nullptr, chunkSize, worldSeed, options )
+{
+}
+
+PoissonDiskChunkSampler::PoissonDiskChunkSampler( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options )
+: PoissonDiskChunkSampler( distFunction, minSeparation, maxSeparation, nullptr, chunkSize, worldSeed, options )
+{
+}
+
+PoissonDiskChunkSampler::PoissonDiskChunkSampler( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options )
+: mDistFunction( distFunction ), mBoundsFunction( boundsFunction ), mMinSeparation( minSeparation ), mMaxSeparation( maxSeparation ),
+mChunkSize( glm::max( chunkSize, 2.0f * maxSeparation ) ), mWorldSeed( worldSeed ), mOptions( options ), mCacheSize( 256 )
+{
+}
+
+std::vector<glm::vec2> PoissonDiskChunkSampler::getChunk( const glm::ivec2 &coords )
+{
+	std::vector<glm::vec2> output;
+	sampleChunk( coords, &output );
+	return output;
+}
+
+ci::Rectf PoissonDiskChunkSampler::getChunkBounds( const glm::ivec2 &coords ) const
+{
+	vec2 min = vec2( coords ) * mChunkSize;
+	return Rectf( min, min + vec2( mChunkSize ) );
+}
+
+glm::ivec2 PoissonDiskChunkSampler::getChunkCoords( const glm::vec2 &p ) const
+{
+	return ivec2( glm::floor( p / mChunkSize ) );
+}
+
+void PoissonDiskChunkSampler::setCacheSize( size_t size )
+{
+	lock_guard<mutex> lock( mCacheMutex );
+	mCacheSize = size;
+	while( mCache.size() > mCacheSize ) {
+		mCacheMap.erase( mCache.front().first );
+		mCache.pop_front();
+	}
+}
+
+void PoissonDiskChunkSampler::clearCache()
+{
+	lock_guard<mutex> lock( mCacheMutex );
+	mCache.clear();
+	mCacheMap.clear();
+}
+
+namespace {
+	uint64_t getChunkKey( const ivec2 &coords ) { return static_cast<uint64_t>( static_cast<uint32_t>( coords.x ) ) << 32 | static_cast<uint32_t>( coords.y ); }
+	int getChunkColor( const ivec2 &coords ) { return ( coords.x & 1 ) | ( coords.y & 1 ) << 1; }
+	
+	template<typename GridT>
+	void sampleChunkGrid( GridT &grid, PoissonDiskRandom &rng, const std::function<float(const vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const vec2&)> &boundsFunction, const Rectf &bounds, const std::vector<const std::vector<vec2>*> &neighbors, const PoissonDiskOptions &options, std::vector<vec2> *output )
+	{
+		std::vector<int32_t> processingList;
+		std::vector<vec2> initialSet;
+		SamplingBudget budget( options );
+		// the chunk margins only hold for separations in the range
+		auto clampedDistFunction = [&]( const vec2 &p ) { return glm::clamp( distFunction( p ), minSeparation, maxSeparation ); };
+		if( distFunction && boundsFunction ) {
+			sampleTile( grid, processingList, rng, clampedDistFunction, minSeparation, boundsFunction, bounds, neighbors, initialSet, options, budget, output );
+		}
+		else if( distFunction ) {
+			sampleTile( grid, processingList, rng, clampedDistFunction, minSeparation, NoBoundsFunction(), bounds, neighbors, initialSet, options, budget, output );
+		}
+		else if( boundsFunction ) {
+			sampleTile( grid, processingList, rng, ConstantSeparation{ minSeparation }, minSeparation, boundsFunction, bounds, neighbors, initialSet, options, budget, output );
+		}
+		else {
+			sampleTile( grid, processingList, rng, ConstantSeparation{ minSeparation }, minSeparation, NoBoundsFunction(), bounds, neighbors, initialSet, options, budget, output );
+		}
+	}
+}
+
+PoissonDiskChunkSampler::BorderRef PoissonDiskChunkSampler::getBorder( const glm::ivec2 &coords )
+{
+	{
+		lock_guard<mutex> lock( mCacheMutex );
+		auto it = mCacheMap.find( getChunkKey( coords ) );
+		if( it != mCacheMap.end() ) {
+			mCache.splice( mCache.end(), mCache, it->second );
+			return it->second->second;
+		}
+	}
+	
+	std::vector<vec2> output;
+	return sampleChunk( coords, &output );
+}
+
+PoissonDiskChunkSampler::BorderRef PoissonDiskChunkSampler::sampleChunk( const glm::ivec2 &coords, std::vector<glm::vec2> *output )
+{
+	// the borders of the neighbors of lower phases seed the chunk, the shared pointers keep
+	// them alive even if they get evicted from the cache by another thread
+	int color = getChunkColor( coords );
+	std::vector<BorderRef> borders;
+	std::vector<const std::vector<vec2>*> neighbors;
+	for( int y = -1; y <= 1; y++ ) {
+		for( int x = -1; x <= 1; x++ ) {
+			ivec2 neighbor = coords + ivec2( x, y );
+			if( getChunkColor( neighbor ) < color ) {
+				borders.push_back( getBorder( neighbor ) );
+				neighbors.push_back( borders.back().get() );
+			}
+		}
+	}
+	
+	Rectf bounds		= getChunkBounds( coords );
+	float margin		= 2.0f * mMaxSeparation;
+	float cellSize		= getCellSize( mMinSeparation, mMaxSeparation );
+	Rectf gridBounds( bounds.getUpperLeft() - vec2( margin ), bounds.getLowerRight() + vec2( margin ) );
+	PoissonDiskRandom rng( hashSeed( hashSeed( mWorldSeed, static_cast<uint32_t>( coords.x ) ), static_cast<uint32_t>( coords.y ) ) );
+	if( isMultiLevel( mMinSeparation, mMaxSeparation ) ) {
+		MultiLevelGrid<vec2> grid( gridBounds, mMinSeparation, mMaxSeparation );
+		sampleChunkGrid( grid, rng, mDistFunction, mMinSeparation, mMaxSeparation, mBoundsFunction, bounds, neighbors, mOptions, output );
+	}
+	else {
+		Grid<vec2> grid( gridBounds, cellSize, getCellCapacity( cellSize, mMinSeparation ) );
+		sampleChunkGrid( grid, rng, mDistFunction, mMinSeparation, mMaxSeparation, mBoundsFunction, bounds, neighbors, mOptions, output );
+	}
+	
+	// keep the points close enough to the edges to be seen by the neighbors
+	auto border = make_shared<std::vector<vec2>>();
+	Rectf inner( bounds.getUpperLeft() + vec2( margin ), bounds.getLowerRight() - vec2( margin ) );
+	for( const auto &p : *output ) {
+		if( p.x < inner.x1 || p.y < inner.y1 || p.x > inner.x2 || p.y > inner.y2 ) {
+			border->push_back( p );
+		}
+	}
+	
+	lock_guard<mutex> lock( mCacheMutex );
+	uint64_t key = getChunkKey( coords );
+	auto it = mCacheMap.find( key );
+	if( it != mCacheMap.end() ) {
+		mCache.splice( mCache.end(), mCache, it->second );
+		return it->second->second;
+	}
+	mCacheMap[key] = mCache.insert( mCache.end(), CacheEntry( key, border ) );
+	while( mCache.size() > mCacheSize ) {
+		mCacheMap.erase( mCache.front().first );
+		mCache.pop_front();
+	}
+	return border;
+}
+
+template<typename VecT>
+PoissonDiskIndexT<VecT>::PoissonDiskIndexT( const std::vector<VecT> &points, float separation )
+{
+	if( points.empty() ) {
+		return;
+	}
+	VecT min = points.front(), max = points.front();
+	for( const auto &p : points ) {
+		min = glm::min( min, p );
+		max = glm::max( max, p );
+	}
+	setupGrid( mGrid, makeBounds( min, max ), separation, separation );
+	mGrid.reserve( points.size() );
+	for( const auto &p : points ) {
+		mGrid.add( p );
+	}
+	findOutsidePoints();
+}
+
+template<typename VecT>
+PoissonDiskIndexT<VecT>::PoissonDiskIndexT( Grid<VecT> &&grid )
+: mGrid( std::move( grid ) )
+{
+	findOutsidePoints();
+}
+
+template<typename VecT>
+void PoissonDiskIndexT<VecT>::findOutsidePoints()
+{
+	mGrid.setStats( nullptr );
+	for( size_t i = 0; i < mGrid.getNumPoints(); i++ ) {
+		if( ! mGrid.contains( mGrid.getPoint( static_cast<int32_t>( i ) ) ) ) {
+			mOutside.push_back( static_cast<int32_t>( i ) );
+		}
+	}
+}
+
+template<typename VecT>
+void PoissonDiskIndexT<VecT>::getPointsInRadius( const VecT &p, float radius, std::vector<int32_t> *indices ) const
+{
+	if( empty() ) {
+		return;
+	}
+	size_t first = indices->size();
+	mGrid.getPointsInCells( p - VecT( radius ), p + VecT( radius ), indices );
+	indices->insert( indices->end(), mOutside.begin(), mOutside.end() );
+	indices->erase( remove_if( indices->begin() + first, indices->end(), [&]( int32_t index ) { return glm::distance( p, mGrid.getPoint( index ) ) >= radius; } ), indices->end() );
+}
+
+template<typename VecT>
+void PoissonDiskIndexT<VecT>::getPointsInBounds( const BoundsT &bounds, std::vector<int32_t> *indices ) const
+{
+	if( empty() ) {
+		return;
+	}
+	size_t first = indices->size();
+	mGrid.getPointsInCells( getMin( bounds ), getMax( bounds ), indices );
+	indices->insert( indices->end(), mOutside.begin(), mOutside.end() );
+	indices->erase( remove_if( indices->begin() + first, indices->end(), [&]( int32_t index ) { return ! poisson_detail::contains( bounds, mGrid.getPoint( index ) ); } ), indices->end() );
+}
+
+template<typename VecT>
+int32_t PoissonDiskIndexT<VecT>::getNearest( const VecT &p, float maxDistance ) const
+{
+	int32_t nearest		= mGrid.getNearest( p, maxDistance );
+	float nearestDist	= nearest >= 0 ? glm::distance( p, mGrid.getPoint( nearest ) ) : maxDistance;
+	for( int32_t index : mOutside ) {
+		float dist = glm::distance( p, mGrid.getPoint( index ) );
+		if( dist < nearestDist ) {
+			nearestDist = dist;
+			nearest		= index;
+		}
+	}
+	return nearest;
+}
+
+template class PoissonDiskIndexT<vec2>;
+template class PoissonDiskIndexT<vec3>;
+
+namespace {
+	//! samples the points of an index straight into its grid, unless the grid of the distribution can't be taken over
+	template<typename VecT, typename DistFn, typename BoundsFn>
+	PoissonDiskIndexT<VecT> sampleIndex( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+	{
+		if( options.getEngine() == PoissonDiskOptions::BRIDSON && ! options.isTiled() && options.getOrder() == PoissonDiskOptions::ACCEPTANCE_ORDER && ! isMultiLevel( minSeparation, maxSeparation ) ) {
+			Grid<VecT> grid;
+			std::vector<int32_t> processingList;
+			sampleGrid<PoissonDiskRandom>( grid, processingList, distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, NoSink() );
+			return PoissonDiskIndexT<VecT>( std::move( grid ) );
+		}
+		return PoissonDiskIndexT<VecT>( poisson_detail::poissonDiskDistribution<VecT, PoissonDiskRandom>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options ), minSeparation );
+	}
+}
+
+PoissonDiskIndex poissonDiskDistributionIndex( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( ConstantSeparation{ separation }, separation, separation, NoBoundsFunction(), area, initialSet, options );
+}
+
+PoissonDiskIndex poissonDiskDistributionIndex( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( distFunction, minSeparation, maxSeparation, NoBoundsFunction(), area, initialSet, options );
+}
+
+PoissonDiskIndex poissonDiskDistributionIndex( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( distFunction, minSeparation, maxSeparation, boundsFunction, area, initialSet, options );
+}
+
+PoissonDiskIndex3d poissonDiskDistributionIndex( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( ConstantSeparation{ separation }, separation, separation, NoBoundsFunction(), bounds, initialSet, options );
+}
+
+PoissonDiskIndex3d poissonDiskDistributionIndex( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( distFunction, minSeparation, maxSeparation, NoBoundsFunction(), bounds, initialSet, options );
+}
+
+PoissonDiskIndex3d poissonDiskDistributionIndex( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return sampleIndex( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options );
+}
+
+PoissonDiskEditor::PoissonDiskEditor( float separation, const ci::Rectf &bounds, const PoissonDiskOptions &options )
+: PoissonDiskEditor( nullptr, separation, separation, nullptr, bounds, options )
+{
+}
+
+PoissonDiskEditor::PoissonDiskEditor( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &bounds, const PoissonDiskOptions &options )
+: PoissonDiskEditor( distFunction, minSeparation, maxSeparation, nullptr, bounds, options )
+{
+}
+
+PoissonDiskEditor::PoissonDiskEditor( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &bounds, const PoissonDiskOptions &options )
+: mDistFunction( distFunction ), mBoundsFunction( boundsFunction ), mMinSeparation( minSeparation ), mMaxSeparation( maxSeparation ),
+mBounds( glm::min( bounds.getUpperLeft(), bounds.getLowerRight() ), glm::max( bounds.getUpperLeft(), bounds.getLowerRight() ) ), mOptions( options ), mRng( getSeed( options ) )
+{
+	float cellSize = getCellSize( mMinSeparation, mMaxSeparation );
+	mGrid.resize( mBounds, cellSize, getCellCapacity( cellSize, mMinSeparation ) );
+	mGrid.reserve( getMaxNumPoints( mBounds, mMinSeparation ) );
+	fill( mBounds );
+}
+
+template<typename RegionFn>
+size_t PoissonDiskEditor::eraseIf( const ci::Rectf &region, const RegionFn &contains )
+{
+	mIndices.clear();
+	mGrid.getPointsInCells( glm::min( region.getUpperLeft(), region.getLowerRight() ), glm::max( region.getUpperLeft(), region.getLowerRight() ), &mIndices );
+	mIndices.erase( remove_if( mIndices.begin(), mIndices.end(), [&]( int32_t index ) { return ! contains( mGrid.getPoint( index ) ); } ), mIndices.end() );
+	
+	// removing the highest indices first guarantees that the last point is never one that still has to be removed
+	sort( mIndices.begin(), mIndices.end(), greater<int32_t>() );
+	for( int32_t index : mIndices ) {
+		mGrid.remove( index );
+	}
+	return mIndices.size();
+}
+
+size_t PoissonDiskEditor::erase( const ci::Rectf &region )
+{
+	vec2 min = glm::min( region.getUpperLeft(), region.getLowerRight() );
+	vec2 max = glm::max( region.getUpperLeft(), region.getLowerRight() );
+	return eraseIf( region, [&]( const vec2 &p ) { return p.x >= min.x && p.y >= min.y && p.x <= max.x && p.y <= max.y; } );
+}
+
+size_t PoissonDiskEditor::erase( const glm::vec2 &center, float radius )
+{
+	return eraseIf( Rectf( center - vec2( radius ), center + vec2( radius ) ), [&]( const vec2 &p ) { return glm::length2( p - center ) <= radius * radius; } );
+}
+
+size_t PoissonDiskEditor::fill( const ci::Rectf &region )
+{
+	// clip the region to the distribution bounds
+	vec2 min = glm::max( glm::min( region.getUpperLeft(), region.getLowerRight() ), mBounds.getUpperLeft() );
+	vec2 max = glm::min( glm::max( region.getUpperLeft(), region.getLowerRight() ), mBounds.getLowerRight() );
+	if( min.x > max.x || min.y > max.y ) {
+		return 0;
+	}
+	Rectf bounds( min, max );
+	
+	// seed the active list with the points close enough to spawn candidates in the region
+	mProcessingList.clear();
+	mGrid.getPointsInCells( min - vec2( 2.0f * mMaxSeparation ), max + vec2( 2.0f * mMaxSeparation ), &mProcessingList );
+	
+	size_t numPoints = mGrid.getNumPoints();
+	auto getSeparation = [&]( const vec2 &p ) { return mDistFunction ? mDistFunction( p ) : mMinSeparation; };
+	auto isValid = [&]( const vec2 &p ) { return ( ! mBoundsFunction || mBoundsFunction( p ) ) && ! mGrid.hasNeighbors( p, getSeparation( p ) ); };
+	
+	// if there's nothing around the region start from its center or from a random point
+	if( mProcessingList.empty() ) {
+		for( int i = 0; i < glm::max( mOptions.getK(), 1 ); i++ ) {
+			vec2 p = i == 0 ? bounds.getCenter() : randPoint( mRng, bounds );
+			if( isValid( p ) ) {
+				mProcessingList.push_back( mGrid.add( p ) );
+				break;
+			}
+		}
+	}
+	
+	auto onAccepted = []( int32_t ) {};
+	SamplingBudget budget( mOptions );
+	if( mDistFunction && mBoundsFunction ) {
+		processActiveList( mGrid, mProcessingList, mRng, mDistFunction, mBoundsFunction, bounds, mOptions, budget, onAccepted );
+	}
+	else if( mDistFunction ) {
+		processActiveList( mGrid, mProcessingList, mRng, mDistFunction, NoBoundsFunction(), bounds, mOptions, budget, onAccepted );
+	}
+	else if( mBoundsFunction ) {
+		processActiveList( mGrid, mProcessingList, mRng, ConstantSeparation{ mMinSeparation }, mBoundsFunction, bounds, mOptions, budget, onAccepted );
+	}
+	else {
+		processActiveList( mGrid, mProcessingList, mRng, ConstantSeparation{ mMinSeparation }, NoBoundsFunction(), bounds, mOptions, budget, onAccepted );
+	}
+	return mGrid.getNumPoints() - numPoints;
+}
+
+size_t PoissonDiskEditor::resample( const ci::Rectf &region )
+{
+	erase( region );
+	return fill( region );
+}
+
+size_t PoissonDiskEditor::resample( const glm::vec2 &center, float radius )
+{
+	erase( center, radius );
+	return fill( Rectf( center - vec2( radius ), center + vec2( radius ) ) );
+}
+
+void PoissonDiskEditor::setDistFunction( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation )
+{
+	mDistFunction = distFunction;
+	if( minSeparation != mMinSeparation || maxSeparation != mMaxSeparation ) {
+		mMinSeparation = minSeparation;
+		mMaxSeparation = maxSeparation;
+		
+		// rebuild the grid with the new layout
+		std::vector<vec2> points = mGrid.getPoints();
+		float cellSize = getCellSize( mMinSeparation, mMaxSeparation );
+		mGrid.resize( mBounds, cellSize, getCellCapacity( cellSize, mMinSeparation ) );
+		mGrid.reserve( getMaxNumPoints( mBounds, mMinSeparation ) );
+		for( const auto &p : points ) {
+			mGrid.add( p );
+		}
+	}
+}
+
+namespace {
+	const int kMaxQuantizedCells = 4096;
+	
+	int countTrailingZeros( uint64_t bits )
+	{
+	#if defined( _MSC_VER )
+		unsigned long index;
+		_BitScanForward64( &index, bits );
+		return static_cast<int>( index );
+	#else
+		return __builtin_ctzll( bits );
+	#endif
+	}
+}
+
+PoissonDiskQuantizedPoints::PoissonDiskQuantizedPoints( Format format, const ci::Rectf &bounds, float separation )
+	: mFormat( format ), mBounds( bounds ), mNumPoints( 0 ), mCellSize( 0.0f ), mNumCells( 0 )
+{
+	if( mFormat == CELL_OFFSET ) {
+		// cells hold a single point as long as their diagonal is the minimum separation
+		vec2 size		= bounds.getSize();
+		mCellSize		= glm::max( separation / sqrt( 2.0f ), glm::max( size.x, size.y ) / kMaxQuantizedCells );
+		mCellSize		= mCellSize > 0.0f ? mCellSize : 1.0f;
+		mNumCells		= glm::clamp( ivec2( glm::ceil( size / mCellSize ) ), ivec2( 1 ), ivec2( kMaxQuantizedCells ) );
+		size_t numCells	= static_cast<size_t>( mNumCells.x ) * mNumCells.y;
+		mOccupancy.resize( ( numCells + 63 ) / 64, 0 );
+		mOffsets.resize( numCells, 0 );
+	}
+}
+
+PoissonDiskQuantizedPoints::PoissonDiskQuantizedPoints( Format format, const glm::vec2 *points, size_t count, const ci::Rectf &bounds, float separation )
+	: PoissonDiskQuantizedPoints( format, bounds, separation )
+{
+	append( points, count );
+	finish();
+}
+
+void PoissonDiskQuantizedPoints::append( const glm::vec2 *points, size_t count )
+{
+	if( mFormat == CELL_OFFSET ) {
+		if( ! mRanks.empty() ) {
+			expand();
+		}
+		vec2 min = mBounds.getUpperLeft();
+		for( size_t i = 0; i < count; i++ ) {
+			if( ! mBounds.contains( points[i] ) ) {
+				mOverflow.push_back( points[i] );
+				continue;
+			}
+			vec2 c		= ( points[i] - min ) / mCellSize;
+			ivec2 cell	= glm::clamp( ivec2( glm::floor( c ) ), ivec2( 0 ), mNumCells - ivec2( 1 ) );
+			size_t j	= cell.x + static_cast<size_t>( mNumCells.x ) * cell.y;
+			uint64_t bit = 1ULL << ( j & 63 );
+			if( mOccupancy[j >> 6] & bit ) {
+				mOverflow.push_back( points[i] );
+				continue;
+			}
+			ivec2 offset		= glm::clamp( ivec2( glm::floor( ( c - vec2( cell ) ) * 256.0f ) ), ivec2( 0 ), ivec2( 255 ) );
+			mOccupancy[j >> 6]	|= bit;
+			mOffsets[j]			= static_cast<uint16_t>( offset.x | offset.y << 8 );
+		}
+	}
+	else {
+		size_t first = mCoords.size();
+		mCoords.resize( first + 2 * count );
+		for( size_t i = 0; i < count; i++ ) {
+			uint16_t *coords = mCoords.data() + first + 2 * i;
+			if( mFormat == UNORM16 ) {
+				toUnorm16( points[i], mBounds, coords );
+			}
+			else {
+				coords[0] = floatToHalf( points[i].x );
+				coords[1] = floatToHalf( points[i].y );
+			}
+		}
+	}
+	mNumPoints += count;
+}
+
+void PoissonDiskQuantizedPoints::finish()
+{
+	if( mFormat != CELL_OFFSET || mRanks.size() == mOccupancy.size() ) {
+		return;
+	}
+	
+	// move the offsets of the occupied cells to the front, in cell order
+	mRanks.resize( mOccupancy.size() );
+	uint32_t rank = 0;
+	for( size_t w = 0; w < mOccupancy.size(); w++ ) {
+		mRanks[w] = rank;
+		for( uint64_t bits = mOccupancy[w]; bits; bits &= bits - 1 ) {
+			mOffsets[rank++] = mOffsets[w * 64 + countTrailingZeros( bits )];
+		}
+	}
+	mOffsets.resize( rank );
+	mOffsets.shrink_to_fit();
+}
+
+void PoissonDiskQuantizedPoints::expand()
+{
+	// move the offsets of the occupied cells back to their cells
+	std::vector<uint16_t> offsets( static_cast<size_t>( mNumCells.x ) * mNumCells.y, 0 );
+	size_t index = 0;
+	for( size_t w = 0; w < mOccupancy.size(); w++ ) {
+		for( uint64_t bits = mOccupancy[w]; bits; bits &= bits - 1 ) {
+			offsets[w * 64 + countTrailingZeros( bits )] = mOffsets[index++];
+		}
+	}
+	mOffsets.swap( offsets );
+	mRanks.clear();
+}
+
+size_t PoissonDiskQuantizedPoints::getDataSize() const
+{
+	if( mFormat != CELL_OFFSET ) {
+		return mCoords.size() * sizeof( uint16_t );
+	}
+	return mOccupancy.size() * sizeof( uint64_t ) + mRanks.size() * sizeof( uint32_t ) + mOffsets.size() * sizeof( uint16_t ) + mOverflow.size() * sizeof( vec2 );
+}
+
+glm::vec2 PoissonDiskQuantizedPoints::getCellPoint( size_t index ) const
+{
+	if( index >= mOffsets.size() ) {
+		return mOverflow[index - mOffsets.size()];
+	}
+	
+	// find the word holding the point and its bit among the ones of the word
+	size_t w		= std::upper_bound( mRanks.begin(), mRanks.end(), static_cast<uint32_t>( index ) ) - mRanks.begin() - 1;
+	uint64_t bits	= mOccupancy[w];
+	for( size_t i = mRanks[w]; i < index; i++ ) {
+		bits &= bits - 1;
+	}
+	return getCellPoint( w * 64 + countTrailingZeros( bits ), mOffsets[index] );
+}
+
+glm::vec2 PoissonDiskQuantizedPoints::getCellPoint( size_t cell, uint16_t offset ) const
+{
+	vec2 coords( cell % mNumCells.x, cell / mNumCells.x );
+	return mBounds.getUpperLeft() + ( coords + ( vec2( offset & 0xff, offset >> 8 ) + vec2( 0.5f ) ) / 256.0f ) * mCellSize;
+}
+
+std::vector<glm::vec2> PoissonDiskQuantizedPoints::decode() const
+{
+	std::vector<vec2> points;
+	decode( &points );
+	return points;
+}
+
+void PoissonDiskQuantizedPoints::decode( std::vector<glm::vec2> *output ) const
+{
+	output->reserve( output->size() + mNumPoints );
+	if( mFormat == CELL_OFFSET ) {
+		size_t index = 0;
+		for( size_t w = 0; w < mOccupancy.size(); w++ ) {
+			for( uint64_t bits = mOccupancy[w]; bits; bits &= bits - 1 ) {
+				output->push_back( getCellPoint( w * 64 + countTrailingZeros( bits ), mOffsets[index++] ) );
+			}
+		}
+		output->insert( output->end(), mOverflow.begin(), mOverflow.end() );
+	}
+	else {
+		for( size_t i = 0; i < mNumPoints; i++ ) {
+			output->push_back( getPoint( i ) );
+		}
+	}
+}
+
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	PoissonDiskQuantizedPoints points( format, area, separation );
+	poissonDiskDistributionStream( [&]( const vec2 *p, size_t count ) { points.append( p, count ); }, separation, area, initialSet, options );
+	points.finish();
+	return points;
+}
+
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	PoissonDiskQuantizedPoints points( format, area, minSeparation );
+	poissonDiskDistributionStream( [&]( const vec2 *p, size_t count ) { points.append( p, count ); }, distFunction, minSeparation, maxSeparation, area, initialSet, options );
+	points.finish();
+	return points;
+}
+
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	PoissonDiskQuantizedPoints points( format, area, minSeparation );
+	poissonDiskDistributionStream( [&]( const vec2 *p, size_t count ) { points.append( p, count ); }, distFunction, minSeparation, maxSeparation, boundsFunction, area, initialSet, options );
+	points.finish();
+	return points;
+}
+
+namespace {
+	const uint32_t kCacheMagic		= 0x43444450; // "PDDC"
+	const uint32_t kCacheVersion	= 1;
+	
+	struct CacheHeader {
+		uint32_t	mMagic;
+		uint32_t	mVersion;
+		uint32_t	mFormat;
+		uint32_t	mNumPoints;
+		uint64_t	mKey;
+		float		mBounds[4];
+	};
+	
+	size_t getPointSize( PoissonDiskCachedPoints::Format format ) { return format == PoissonDiskCachedPoints::FLOAT32 ? sizeof( vec2 ) : 2 * sizeof( uint16_t ); }
+	
+	//! FNV-1a hash of the parameters
+	class CacheKey {
+	public:
+		CacheKey() : mHash( 0xcbf29ce484222325ULL ) {}
+		
+		template<typename T>
+		CacheKey& add( const T &value )
+		{
+			const uint8_t *bytes = reinterpret_cast<const uint8_t*>( &value );
+			for( size_t i = 0; i < sizeof( T ); i++ ) {
+				mHash = ( mHash ^ bytes[i] ) * 0x100000001b3ULL;
+			}
+			return *this;
+		}
+		uint64_t getHash() const { return mHash; }
+		
+	protected:
+		uint64_t mHash;
+	};
+	
+	//! maps the whole file at \a path in memory, returns nullptr if it doesn't exist or can't be mapped
+	void* mapFile( const string &path, size_t *size )
+	{
+	#if defined( _WIN32 )
+		HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+		if( file == INVALID_HANDLE_VALUE ) {
+			return nullptr;
+		}
+		LARGE_INTEGER fileSize;
+		void *view = nullptr;
+		if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 ) {
+			// the view keeps the mapping alive once the handles are closed
+			HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+			if( mapping ) {
+				view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+				CloseHandle( mapping );
+			}
+			*size = static_cast<size_t>( fileSize.QuadPart );
+		}
+		CloseHandle( file );
+		return view;
+	#else
+		int file = open( path.c_str(), O_RDONLY );
+		if( file < 0 ) {
+			return nullptr;
+		}
+		struct stat status;
+		void *view = nullptr;
+		if( fstat( file, &status ) == 0 && status.st_size > 0 ) {
+			view = mmap( nullptr, static_cast<size_t>( status.st_size ), PROT_READ, MAP_PRIVATE, file, 0 );
+			if( view == MAP_FAILED ) {
+				view = nullptr;
+			}
+			*size = static_cast<size_t>( status.st_size );
+		}
+		close( file );
+		return view;
+	#endif
+	}
+	
+	void unmapFile( void *view, size_t size )
+	{
+	#if defined( _WIN32 )
+		UnmapViewOfFile( view );
+	#else
+		munmap( view, size );
+	#endif
+	}
+	
+	//! returns whether the distribution sampled with \a options only depends on them, and not on time or thread scheduling. Point budgets are shared by the tiles and by the threads of the dart throwing engine, which then keep the points of whichever wins the race.
+	bool isDeterministic( const PoissonDiskOptions &options )
+	{
+		return options.hasSeed() && options.getTimeBudget() <= 0.0 && ! ( options.getMaxPoints() && ( options.isTiled() || options.getEngine() == PoissonDiskOptions::DART_THROWING ) );
+	}
+}
+
+PoissonDiskCachedPoints::PoissonDiskCachedPoints()
+	: mData( nullptr ), mNumPoints( 0 ), mFormat( FLOAT32 ), mMapping( nullptr ), mMappingSize( 0 )
+{
+}
+
+PoissonDiskCachedPoints::PoissonDiskCachedPoints( PoissonDiskCachedPoints &&other )
+	: mData( other.mData ), mNumPoints( other.mNumPoints ), mFormat( other.mFormat ), mBounds( other.mBounds ), mMapping( other.mMapping ), mMappingSize( other.mMappingSize ), mBuffer( std::move( other.mBuffer ) )
+{
+	other.mData			= nullptr;
+	other.mNumPoints	= 0;
+	other.mMapping		= nullptr;
+	other.mMappingSize	= 0;
+}
+
+PoissonDiskCachedPoints& PoissonDiskCachedPoints::operator=( PoissonDiskCachedPoints &&other )
+{
+	if( this != &other ) {
+		if( mMapping ) {
+			unmapFile( mMapping, mMappingSize );
+		}
+		mData				= other.mData;
+		mNumPoints			= other.mNumPoints;
+		mFormat				= other.mFormat;
+		mBounds				= other.mBounds;
+		mMapping			= other.mMapping;
+		mMappingSize		= other.mMappingSize;
+		mBuffer				= std::move( other.mBuffer );
+		other.mData			= nullptr;
+		other.mNumPoints	= 0;
+		other.mMapping		= nullptr;
+		other.mMappingSize	= 0;
+	}
+	return *this;
+}
+
+PoissonDiskCachedPoints::~PoissonDiskCachedPoints()
+{
+	if( mMapping ) {
+		unmapFile( mMapping, mMappingSize );
+	}
+}
+
+std::vector<glm::vec2> PoissonDiskCachedPoints::decode() const
+{
+	std::vector<vec2> points( mNumPoints );
+	for( size_t i = 0; i < mNumPoints; i++ ) {
+		points[i] = getPoint( i );
+	}
+	return points;
+}
+
+PoissonDiskCache::PoissonDiskCache( const std::string &directory, PoissonDiskCachedPoints::Format format )
+	: mDirectory( directory ), mFormat( format )
+{
+}
+
+PoissonDiskCachedPoints PoissonDiskCache::get( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return getOrSample( [&]() { return poissonDiskDistribution( separation, area, initialSet, options ); }, separation, separation, 0, area, initialSet, options );
+}
+
+PoissonDiskCachedPoints PoissonDiskCache::get( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, uint32_t version, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return getOrSample( [&]() { return poissonDiskDistribution( distFunction, minSeparation, maxSeparation, area, initialSet, options ); }, minSeparation, maxSeparation, static_cast<uint64_t>( version ) << 2 | 1, area, initialSet, options );
+}
+
+PoissonDiskCachedPoints PoissonDiskCache::get( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, uint32_t version, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return getOrSample( [&]() { return poissonDiskDistribution( distFunction, minSeparation, maxSeparation, boundsFunction, area, initialSet, options ); }, minSeparation, maxSeparation, static_cast<uint64_t>( version ) << 2 | 2, area, initialSet, options );
+}
+
+PoissonDiskCachedPoints PoissonDiskCache::getOrSample( const std::function<std::vector<glm::vec2>()> &sample, float minSeparation, float maxSeparation, uint64_t functionsVersion, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	PoissonDiskCachedPoints result;
+	result.mFormat = mFormat;
+	result.mBounds = area;
+	
+	// results that depend on time or thread scheduling can't be cached
+	bool isCacheable = isDeterministic( options );
+	
+	// hash everything the result depends on, the number of threads and chunk size excepted
+	CacheKey key;
+	key.add( kCacheVersion ).add( static_cast<uint32_t>( mFormat ) ).add( functionsVersion );
+	key.add( area.x1 ).add( area.y1 ).add( area.x2 ).add( area.y2 ).add( minSeparation ).add( maxSeparation );
+	key.add( options.getK() ).add( options.getSeed() ).add( options.isStableOrder() ).add( static_cast<uint32_t>( options.getCandidateMode() ) ).add( static_cast<uint32_t>( options.getEngine() ) );
+	key.add( options.isTiled() ).add( options.isTiled() ? options.getTileSize() : 0.0f ).add( static_cast<uint64_t>( options.getMaxPoints() ) );
+	key.add( options.getMinAcceptanceRate() ).add( static_cast<uint64_t>( options.getMinAcceptanceRate() > 0.0f ? options.getAcceptanceWindow() : 0 ) ).add( options.isAdaptiveK() ? options.getMinK() : 0 ).add( static_cast<uint32_t>( options.getOrder() ) );
+	for( const auto &p : initialSet ) {
+		key.add( p.x ).add( p.y );
+	}
+	
+	char name[32];
+	snprintf( name, sizeof( name ), "%016llx.pdd", static_cast<unsigned long long>( key.getHash() ) );
+	string path = mDirectory.empty() || mDirectory.back() == '/' || mDirectory.back() == '\\' ? mDirectory + name : mDirectory + "/" + name;
+	
+	// map the file if it's there and valid
+	if( isCacheable ) {
+		size_t size = 0;
+		void *view = mapFile( path, &size );
+		if( view ) {
+			const CacheHeader *header = static_cast<const CacheHeader*>( view );
+			if( size >= sizeof( CacheHeader ) && header->mMagic == kCacheMagic && header->mVersion == kCacheVersion && header->mKey == key.getHash() && header->mFormat == static_cast<uint32_t>( mFormat )
+			   && size >= sizeof( CacheHeader ) + header->mNumPoints * getPointSize( mFormat ) ) {
+				result.mMapping		= view;
+				result.mMappingSize	= size;
+				result.mData		= static_cast<const uint8_t*>( view ) + sizeof( CacheHeader );
+				result.mNumPoints	= header->mNumPoints;
+				return result;
+			}
+			CI_LOG_W( "Invalid cache file " << path << ", sampling it again" );
+			unmapFile( view, size );
+		}
+	}
+	
+	// sample and encode the points
+	vector<vec2> points	= sample();
+	result.mBuffer.resize( points.size() * getPointSize( mFormat ) );
+	uint16_t *coords	= reinterpret_cast<uint16_t*>( result.mBuffer.data() );
+	for( size_t i = 0; i < points.size(); i++ ) {
+		if( mFormat == PoissonDiskCachedPoints::FLOAT32 ) {
+			reinterpret_cast<vec2*>( result.mBuffer.data() )[i] = points[i];
+		}
+		else if( mFormat == PoissonDiskCachedPoints::FLOAT16 ) {
+			coords[2 * i]		= floatToHalf( points[i].x );
+			coords[2 * i + 1]	= floatToHalf( points[i].y );
+		}
+		else {
+			toUnorm16( points[i], area, coords + 2 * i );
+		}
+	}
+	result.mData		= result.mBuffer.data();
+	result.mNumPoints	= points.size();
+	
+	// write to a temporary file first so that concurrent processes never map a partial file
+	if( isCacheable ) {
+		CacheHeader header = { kCacheMagic, kCacheVersion, static_cast<uint32_t>( mFormat ), static_cast<uint32_t>( points.size() ), key.getHash(), { area.x1, area.y1, area.x2, area.y2 } };
+		string tmpPath = path + "." + to_string( random_device()() ) + ".tmp";
+		ofstream stream( tmpPath, ios::binary );
+		stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+		stream.write( reinterpret_cast<const char*>( result.mBuffer.data() ), result.mBuffer.size() );
+		stream.close();
+		if( ! stream ) {
+			CI_LOG_E( "Can't write cache file " << tmpPath );
+			std::remove( tmpPath.c_str() );
+		}
+		else if( std::rename( tmpPath.c_str(), path.c_str() ) != 0 ) {
+			// the file might be there already, ie. written by another process or on platforms where rename doesn't replace files
+			std::remove( path.c_str() );
+			if( std::rename( tmpPath.c_str(), path.c_str() ) != 0 ) {
+				std::remove( tmpPath.c_str() );
+			}
+		}
+	}
+	return result;
 }
\ No newline at end of file
@@ -26,23 +26,2184 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include "cinder/AxisAlignedBox.h"
+#include "cinder/Channel.h"
 #include "cinder/Rect.h"
 #include "cinder/Vector.h"
 
+namespace cinder {
+	class TriMesh;
+}
+
+//! Counters and timings of the distributions, filled when the project is compiled with POISSON_DISK_STATS defined, the instrumentation being compiled out otherwise. Counters of every call using the same stats accumulate, call reset() to start over. With tiled sampling the timings are the sum of the time spent by all the threads.
+struct PoissonDiskStats {
+	PoissonDiskStats() : mNumCandidates( 0 ), mNumOutOfBounds( 0 ), mNumRejectedByBoundsFunction( 0 ), mNumRejectedByNeighbors( 0 ), mNumAccepted( 0 ), mNumNeighborQueries( 0 ), mNumCellsVisited( 0 ), mNumPointsCompared( 0 ), mPeakActiveListSize( 0 ), mSetupTime( 0.0 ), mSamplingTime( 0.0 ), mOutputTime( 0.0 ) {}
+	
+	//! sets all the counters and timings to 0
+	void reset() { *this = PoissonDiskStats(); }
+	//! adds the counters and timings of \a other, keeping the largest peak active list size
+	PoissonDiskStats& operator+=( const PoissonDiskStats &other );
+	
+	uint64_t	mNumCandidates;				// candidates generated around the active points
+	uint64_t	mNumOutOfBounds;			// candidates rejected by the area or bounds
+	uint64_t	mNumRejectedByBoundsFunction; // candidates rejected by the bounds function or mask
+	uint64_t	mNumRejectedByNeighbors;	// candidates too close to a point of the grid or of their batch
+	uint64_t	mNumAccepted;				// candidates added to the distribution
+	uint64_t	mNumNeighborQueries;		// queries of the acceleration grid
+	uint64_t	mNumCellsVisited;			// cells visited by the queries
+	uint64_t	mNumPointsCompared;			// grid slots and points the queries compared to the candidates
+	size_t		mPeakActiveListSize;		// largest number of points in the active list
+	double		mSetupTime;					// seconds spent preparing the grid and the initial points
+	double		mSamplingTime;				// seconds spent processing the active list
+	double		mOutputTime;				// seconds spent gathering the points, or streaming the ones left after sampling
+};
+
+#if defined( POISSON_DISK_STATS )
+	#define POISSON_DISK_STAT( statement ) statement
+#else
+	#define POISSON_DISK_STAT( statement )
+#endif
+
+//! Options shared by the poissonDiskDistribution functions. Implicitly constructible from \a k to stay compatible with the previous signatures.
+class PoissonDiskOptions {
+public:
+	//! Candidate generation kernels
+	enum CandidateMode {
+		//! samples candidates uniformly in the annulus by rejecting points of its bounding square, exact and trig-free
+		ANNULUS_REJECTION,
+		//! picks a direction from a precomputed table of 256 unit vectors, rotated randomly around each active point, and an area-weighted radius. Branchless, the directions around a single point are quantized to the 256 rotated ones
+		DIRECTION_TABLE
+	};
+	
+	//! Sampling algorithms
+	enum Engine {
+		//! Bridson's algorithm, grows the distribution from an active list of points. Serial unless the area is split in tiles.
+		BRIDSON,
+		//! dart throwing in rounds over phase groups of grid cells, every cell of a phase being processed in parallel. Scales with the number of threads and packs points closer to a maximal distribution, at about twice the serial cost of BRIDSON.
+		DART_THROWING
+	};
+	
+	//! Orders of the returned and streamed points
+	enum Order {
+		//! the order in which the points are accepted
+		ACCEPTANCE_ORDER,
+		//! sorted along a Z-order curve
+		MORTON_ORDER,
+		//! sorted along a Hilbert curve, which unlike the Z-order curve never jumps between distant cells. 3D Hilbert sorting ranks the cells with a comparison sort.
+		HILBERT_ORDER
+	};
+	
+	//! Runs \a count tasks, possibly concurrently, and returns once they all completed
+	using ParallelFor = std::function<void( size_t count, const std::function<void( size_t index )> &task )>;
+	
+	PoissonDiskOptions( int k = 30 ) : mK( k ), mSeed( 0 ), mHasSeed( false ), mStableOrder( false ), mCandidateMode( ANNULUS_REJECTION ), mEngine( BRIDSON ), mNumThreads( 1 ), mTileSize( 0.0f ), mChunkSize( 4096 ), mOrder( ACCEPTANCE_ORDER ), mMaxPoints( 0 ), mTimeBudget( 0.0 ), mMinAcceptanceRate( 0.0f ), mAcceptanceWindow( 1024 ), mMinK( 0 ), mStats( nullptr ) {}
+	
+	//! sets the number of candidates spawned around each active point. The higher \a k is the higher the packing will be and slower the algorithm. 8, 16, 30 and 64 use sampling kernels specialized at compile time. Defaults to 30.
+	PoissonDiskOptions& k( int k ) { mK = k; return *this; }
+	//! keeps the active list in insertion order when a point is removed from it instead of replacing it by the last point. This is slower on large areas but makes the processing order independent of removals. Defaults to false.
+	PoissonDiskOptions& stableOrder( bool stable = true ) { mStableOrder = stable; return *this; }
+	//! sets the seed of the random engine used by the distribution. Two calls with the same seed and parameters return the same set of points. By default each call is seeded from std::random_device.
+	PoissonDiskOptions& seed( uint32_t seed ) { mSeed = seed; mHasSeed = true; return *this; }
+	//! sets the kernel used to generate candidates in the annulus around each active point. Defaults to ANNULUS_REJECTION.
+	PoissonDiskOptions& candidateMode( CandidateMode mode ) { mCandidateMode = mode; return *this; }
+	//! sets the algorithm used by the poissonDiskDistribution and streaming functions. With DART_THROWING, k is the number of rounds, the threads and executor process the cells of each phase instead of tiles, and the acceptance rate is measured over each round. Defaults to BRIDSON.
+	PoissonDiskOptions& engine( Engine engine ) { mEngine = engine; return *this; }
+	//! sets the number of threads used to sample the area. With more than one thread, or 0 for the hardware concurrency, the area is split in tiles processed in phases so that tiles sampled concurrently are never adjacent. Tiles use their own grids and the result has the same separation and density as the serial one without matching it point for point. Distance and bounds functions need to be thread-safe. Defaults to 1.
+	PoissonDiskOptions& numThreads( uint32_t numThreads ) { mNumThreads = numThreads; return *this; }
+	//! sets a custom executor used to process the tiles of a phase instead of spawning threads, ie. to plug an existing task system. Enables tiled sampling.
+	PoissonDiskOptions& executor( const ParallelFor &executor ) { mExecutor = executor; return *this; }
+	//! sets the size of the tiles used by tiled sampling. Tiles are always at least twice the maximum separation. Defaults to 0 which picks a size from the separation.
+	PoissonDiskOptions& tileSize( float size ) { mTileSize = size; return *this; }
+	//! sets the number of points passed at once to the sink of the streaming functions. Tiled sampling streams whole tiles instead. Defaults to 4096.
+	PoissonDiskOptions& chunkSize( size_t size ) { mChunkSize = size; return *this; }
+	//! sorts the points along a space-filling curve so that consecutive points and chunks are spatially coherent, ie. to cull instances by chunk with poissonDiskChunkBounds. Points are bucketed in cells of about one point ranked along the curve, without sorting the points themselves. Streaming functions pass the sorted chunks to the sink once sampling is done. Defaults to ACCEPTANCE_ORDER.
+	PoissonDiskOptions& order( Order order ) { mOrder = order; return *this; }
+	
+	//! stops the distribution once it holds \a numPoints points, initial points included. When tiles are sampled concurrently which tiles get the last points depends on the scheduling. Defaults to 0 for no limit.
+	PoissonDiskOptions& maxPoints( size_t numPoints ) { mMaxPoints = numPoints; return *this; }
+	//! stops the distribution after \a seconds of wall-clock time, checked before processing each active point. The points accepted so far are returned. Defaults to 0 for no limit.
+	PoissonDiskOptions& timeBudget( double seconds ) { mTimeBudget = seconds; return *this; }
+	//! stops growing an active list when less than \a rate of its last \a numCandidates candidates were accepted. Each tile and each region a mask restarts from has its own active list. Defaults to 0 which processes the active list until it's empty.
+	PoissonDiskOptions& minAcceptanceRate( float rate, size_t numCandidates = 1024 ) { mMinAcceptanceRate = rate; mAcceptanceWindow = numCandidates; return *this; }
+	//! lowers the number of candidates spawned around each active point from k down to \a minK as the front saturates, following the average number of points recently accepted per active point. Trades some packing for fewer rejected candidates. Doesn't apply to DART_THROWING. Defaults to 0 which always uses k.
+	PoissonDiskOptions& adaptiveK( int minK ) { mMinK = minK; return *this; }
+	
+	//! sets the stats filled by the distributions when compiled with POISSON_DISK_STATS defined. \a stats has to outlive the calls using the options.
+	PoissonDiskOptions& stats( PoissonDiskStats *stats ) { mStats = stats; return *this; }
+	
+	//! returns the number of candidates spawned around each active point
+	int		getK() const { return mK; }
+	//! returns whether the active list is kept in insertion order
+	bool	isStableOrder() const { return mStableOrder; }
+	//! returns the seed of the random engine
+	uint32_t getSeed() const { return mSeed; }
+	//! returns whether a seed has been provided
+	bool	hasSeed() const { return mHasSeed; }
+	//! returns the kernel used to generate candidates
+	CandidateMode getCandidateMode() const { return mCandidateMode; }
+	//! returns the sampling algorithm
+	Engine	getEngine() const { return mEngine; }
+	//! returns the number of threads used to sample the area, 0 meaning the hardware concurrency
+	uint32_t getNumThreads() const { return mNumThreads; }
+	//! returns the custom executor used to process tiles
+	const ParallelFor& getExecutor() const { return mExecutor; }
+	//! returns the size of the tiles used by tiled sampling
+	float	getTileSize() const { return mTileSize; }
+	//! returns whether the area is split in tiles sampled in parallel
+	bool	isTiled() const { return mNumThreads != 1 || mExecutor; }
+	//! returns the number of points passed at once to the sink of the streaming functions
+	size_t	getChunkSize() const { return mChunkSize; }
+	//! returns the order of the returned and streamed points
+	Order	getOrder() const { return mOrder; }
+	//! returns the maximum number of points of the distribution, 0 meaning no limit
+	size_t	getMaxPoints() const { return mMaxPoints; }
+	//! returns the wall-clock budget in seconds, 0 meaning no limit
+	double	getTimeBudget() const { return mTimeBudget; }
+	//! returns the acceptance rate under which an active list stops growing
+	float	getMinAcceptanceRate() const { return mMinAcceptanceRate; }
+	//! returns the number of candidates the acceptance rate is measured over
+	size_t	getAcceptanceWindow() const { return mAcceptanceWindow; }
+	//! returns the lowest number of candidates spawned around an active point with adaptive k, 0 when disabled
+	int		getMinK() const { return mMinK; }
+	//! returns whether the number of candidates adapts to the saturation of the front
+	bool	isAdaptiveK() const { return mMinK > 0 && mMinK < mK; }
+	//! returns the stats filled by the distributions
+	PoissonDiskStats* getStats() const { return mStats; }
+	
+protected:
+	int			mK;
+	uint32_t	mSeed;
+	bool		mHasSeed;
+	bool		mStableOrder;
+	CandidateMode mCandidateMode;
+	Engine		mEngine;
+	uint32_t	mNumThreads;
+	ParallelFor	mExecutor;
+	float		mTileSize;
+	size_t		mChunkSize;
+	Order		mOrder;
+	size_t		mMaxPoints;
+	double		mTimeBudget;
+	float		mMinAcceptanceRate;
+	size_t		mAcceptanceWindow;
+	int			mMinK;
+	PoissonDiskStats *mStats;
+};
+
+//! Small and fast PCG32 (XSH RR) engine satisfying UniformRandomBitGenerator. Used by default by the poissonDiskDistribution functions.
+class PoissonDiskRandom {
+public:
+	using result_type = uint32_t;
+	
+	explicit PoissonDiskRandom( uint64_t seed = 0x853c49e6748fea9bULL ) : mState( 0 ) { operator()(); mState += seed; operator()(); }
+	
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+	
+	result_type operator()()
+	{
+		uint64_t old		= mState;
+		mState				= old * 6364136223846793005ULL + 1442695040888963407ULL;
+		uint32_t xorShifted	= static_cast<uint32_t>( ( ( old >> 18u ) ^ old ) >> 27u );
+		uint32_t rot		= static_cast<uint32_t>( old >> 59u );
+		return ( xorShifted >> rot ) | ( xorShifted << ( ( -rot ) & 31 ) );
+	}
+	
+protected:
+	uint64_t mState;
+};
+
 // 2D Poisson Disk Distribution
 
-//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum \a separation and with a packing determined by how high \a k is. The higher \a k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point.
-std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), int k = 30 );
-//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a k is. The higher \a k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point.
-std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), int k = 30 );
-//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a k is. The higher \a k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point.
+//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum \a separation and with a packing determined by how high \a options k is. The higher k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point.
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. The higher k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point. The range of separations is estimated by probing \a distFunction on a coarse lattice, tiled and dart throwing sampling clamp the separations to it so the overload taking an explicit range should be preferred with them.
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. \a minSeparation and \a maxSeparation are the range of values \a distFunction can return and are used to size the acceleration grid. If no \a initialSet of points is provided the area center will be used as the initial point.
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. The higher k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be used as the initial point. The range of separations is estimated by probing \a distFunction on a coarse lattice, tiled and dart throwing sampling clamp the separations to it so the overload taking an explicit range should be preferred with them.
 //TODO: remove Rectf area arguments and compute bounds inside the function
-std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), int k = 30 );
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and a rectangular \a area, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. \a minSeparation and \a maxSeparation are the range of values \a distFunction can return and are used to size the acceleration grid. If no \a initialSet of points is provided the area center will be used as the initial point.
+std::vector<glm::vec2> poissonDiskDistribution( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// 2D Poisson Disk Distribution with a custom random engine, ie. poissonDiskDistribution<std::mt19937>( ... ). \a URBG is constructed from the options seed and must provide at least 24 random bits per call. \a DistFn and \a BoundsFn can be any callable, lambdas are inlined in the sampling loop.
+
+//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum \a separation, using a \a URBG random engine.
+template<typename URBG>
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples inside a rectangular \a area, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, using a \a URBG random engine.
+template<typename URBG, typename DistFn>
+std::vector<glm::vec2> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and a rectangular \a area, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, using a \a URBG random engine.
+template<typename URBG, typename DistFn, typename BoundsFn>
+std::vector<glm::vec2> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// 2D Poisson Disk Distribution from rasters. Channels are stretched over the whole \a area and are only read during the call. Lookups are inlined in the sampling loop and masks are summarized per cell so that candidates falling in fully masked-out or fully masked-in cells don't read the mask.
+
+//! returns a set of poisson disk samples inside a rectangular \a area, with a separation going from \a maxSeparation where \a density is 0 to \a minSeparation where it is 1. \a density is bilinearly interpolated.
+std::vector<glm::vec2> poissonDiskDistribution( const ci::Channel32f &density, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples inside a rectangular \a area where \a mask is at least 128, with a minimum \a separation. Regions of the mask the distribution can't reach from the initial points are sampled as well.
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Channel8u &mask, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples inside a rectangular \a area where \a mask is at least 128, with a separation going from \a maxSeparation where \a density is 0 to \a minSeparation where it is 1. Regions of the mask the distribution can't reach from the initial points are sampled as well.
+std::vector<glm::vec2> poissonDiskDistribution( const ci::Channel32f &density, float minSeparation, float maxSeparation, const ci::Channel8u &mask, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
 
-//TODO: implement 3d distribution
 // 3D Poisson Disk Distribution
 
-//! returns a set of poisson disk samples within cubic \a bounds, with a minimum \a separation and with a packing determined by how high \a k is. The higher \a k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be use as the first point.
-std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), int k = 30 );
\ No newline at end of file
+//! returns a set of poisson disk samples within cubic \a bounds, with a minimum \a separation and with a packing determined by how high \a options k is. The higher k is the higher the algorithm will be slow. If no \a initialSet of points is provided the area center will be use as the first point.
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within cubic \a bounds, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. If no \a initialSet of points is provided the bounds center will be used as the initial point. The range of separations is estimated by probing \a distFunction on a coarse lattice, tiled and dart throwing sampling clamp the separations to it so the overload taking an explicit range should be preferred with them.
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within cubic \a bounds, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. \a minSeparation and \a maxSeparation are the range of values \a distFunction can return and are used to size the acceleration grid. If no \a initialSet of points is provided the bounds center will be used as the initial point.
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and cubic \a bounds, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. If no \a initialSet of points is provided the bounds center will be used as the initial point. The range of separations is estimated by probing \a distFunction on a coarse lattice, tiled and dart throwing sampling clamp the separations to it so the overload taking an explicit range should be preferred with them.
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and cubic \a bounds, with a minimum separation defined by what \a distFunction returns and with a packing determined by how high \a options k is. \a minSeparation and \a maxSeparation are the range of values \a distFunction can return and are used to size the acceleration grid. If no \a initialSet of points is provided the bounds center will be used as the initial point.
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// 3D Poisson Disk Distribution with a custom random engine
+
+//! returns a set of poisson disk samples within cubic \a bounds, with a minimum \a separation, using a \a URBG random engine.
+template<typename URBG>
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within cubic \a bounds, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, using a \a URBG random engine.
+template<typename URBG, typename DistFn>
+std::vector<glm::vec3> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns a set of poisson disk samples within bounds defined by both \a boundsFunction and cubic \a bounds, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, using a \a URBG random engine.
+template<typename URBG, typename DistFn, typename BoundsFn>
+std::vector<glm::vec3> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// Poisson Disk Distribution on triangle meshes. Candidates are spawned in the plane of the triangle of each active point and projected on the triangles around them, so that fronts cross the edges of the mesh, and the separation is tested in 3D with the same grid as the volume distributions. The cost scales with the surface area of the mesh rather than with the bounds of its triangles.
+
+//! returns a set of poisson disk samples on the triangles of \a mesh with a minimum \a separation. \a triangleIndices, if provided, receives the index of the triangle of each point. The options k, seed, candidateMode, maxPoints, timeBudget and stats apply, the other ones are ignored.
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::TriMesh &mesh, const PoissonDiskOptions &options = PoissonDiskOptions(), std::vector<uint32_t> *triangleIndices = nullptr );
+//! returns a set of poisson disk samples on the triangles of \a mesh with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. \a triangleIndices, if provided, receives the index of the triangle of each point.
+std::vector<glm::vec3> poissonDiskDistribution( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::TriMesh &mesh, const PoissonDiskOptions &options = PoissonDiskOptions(), std::vector<uint32_t> *triangleIndices = nullptr );
+
+// Fixed-count Poisson Disk Distribution. Yuksel's sample elimination, "Sample Elimination for Generating Poisson Disk Sample Sets" (2015): points are removed one by one from a larger set, always the one whose neighbors are the closest, using a heap of weights over neighbors found with the acceleration grid. The result has exactly the requested number of points, without searching for the separation that would give it.
+
+//! returns exactly \a numPoints well spaced points inside a rectangular \a area, eliminated from \a oversampling times as many uniform random points and sorted along a Hilbert curve. The options seed is used, the other options are ignored.
+std::vector<glm::vec2> poissonDiskDistributionFixedCount( size_t numPoints, const ci::Rectf &area, const PoissonDiskOptions &options = PoissonDiskOptions(), float oversampling = 5.0f );
+//! returns exactly \a numPoints well spaced points within cubic \a bounds, eliminated from \a oversampling times as many uniform random points and sorted along a Hilbert curve. The options seed is used, the other options are ignored.
+std::vector<glm::vec3> poissonDiskDistributionFixedCount( size_t numPoints, const ci::AxisAlignedBox &bounds, const PoissonDiskOptions &options = PoissonDiskOptions(), float oversampling = 5.0f );
+//! returns the \a numPoints points of \a points, which cover a rectangular \a area, that remain after eliminating the others, sorted along a Hilbert curve.
+std::vector<glm::vec2> poissonDiskElimination( const std::vector<glm::vec2> &points, size_t numPoints, const ci::Rectf &area );
+//! returns the \a numPoints points of \a points, which cover cubic \a bounds, that remain after eliminating the others, sorted along a Hilbert curve.
+std::vector<glm::vec3> poissonDiskElimination( const std::vector<glm::vec3> &points, size_t numPoints, const ci::AxisAlignedBox &bounds );
+
+// Streaming Poisson Disk Distribution. Instead of being returned, points are passed to \a sink as they're accepted, as a ( const glm::vec2 *points, size_t count ) or ( const glm::vec3 *points, size_t count ) span of up to options chunk size points. The span is only valid during the call.
+
+//! samples a poisson disk distribution inside a rectangular \a area with a minimum \a separation and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn>
+void poissonDiskDistributionStream( const SinkFn &sink, float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples a poisson disk distribution inside a rectangular \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn, typename DistFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples a poisson disk distribution within bounds defined by both \a boundsFunction and a rectangular \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn, typename DistFn, typename BoundsFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples a poisson disk distribution within cubic \a bounds with a minimum \a separation and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn>
+void poissonDiskDistributionStream( const SinkFn &sink, float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples a poisson disk distribution within cubic \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn, typename DistFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples a poisson disk distribution within bounds defined by both \a boundsFunction and cubic \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range and streams the points to \a sink.
+template<typename URBG = PoissonDiskRandom, typename SinkFn, typename DistFn, typename BoundsFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// Chunk bounds of spatially ordered distributions
+
+//! returns the bounding rectangle of each run of \a chunkSize consecutive \a points, ie. to cull the instances of a distribution sampled with PoissonDiskOptions::order chunk by chunk
+std::vector<ci::Rectf> poissonDiskChunkBounds( const std::vector<glm::vec2> &points, size_t chunkSize );
+//! returns the bounding box of each run of \a chunkSize consecutive \a points, ie. to cull the instances of a distribution sampled with PoissonDiskOptions::order chunk by chunk
+std::vector<ci::AxisAlignedBox> poissonDiskChunkBounds( const std::vector<glm::vec3> &points, size_t chunkSize );
+
+// Batched Poisson Disk Distribution
+
+//! Independent 2D distribution of a batch, sampled inside \a mBounds with a separation in the [ \a mMinSeparation, \a mMaxSeparation ] range from a random engine seeded with \a mSeed
+struct PoissonDiskJob {
+	//! creates a job with a constant \a separation
+	PoissonDiskJob( const ci::Rectf &bounds, float separation, uint32_t seed = 0 ) : mBounds( bounds ), mMinSeparation( separation ), mMaxSeparation( separation ), mSeed( seed ) {}
+	//! creates a job whose separation is in the [ \a separationRange.x, \a separationRange.y ] range
+	PoissonDiskJob( const ci::Rectf &bounds, const glm::vec2 &separationRange, uint32_t seed = 0 ) : mBounds( bounds ), mMinSeparation( separationRange.x ), mMaxSeparation( separationRange.y ), mSeed( seed ) {}
+	
+	ci::Rectf	mBounds;
+	float		mMinSeparation, mMaxSeparation;
+	uint32_t	mSeed;
+};
+
+//! samples the \a count \a jobs with their minimum separation and writes their points to \a output, one job after the other. \a offsets receives the index of the first point of each job followed by the total number of points. Jobs are split in contiguous groups processed by up to options.getNumThreads() threads or by the options executor, each group reusing the memory of a single sampler. The result doesn't depend on the number of threads. DART_THROWING samples each job with the dart throwing engine, which allocates for every job.
+void poissonDiskDistributionBatch( const PoissonDiskJob *jobs, size_t count, std::vector<glm::vec2> *output, std::vector<uint32_t> *offsets, const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! samples the \a count \a jobs with a separation defined by what \a distFunction( jobIndex, point ) returns in the separation range of each job and writes their points to \a output, one job after the other. \a offsets receives the index of the first point of each job followed by the total number of points. \a distFunction needs to be thread-safe with more than one thread.
+template<typename URBG = PoissonDiskRandom, typename DistFn>
+void poissonDiskDistributionBatch( const DistFn &distFunction, const PoissonDiskJob *jobs, size_t count, std::vector<glm::vec2> *output, std::vector<uint32_t> *offsets, const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// Poisson Disk Tile Set
+
+//! Set of square poisson disk tiles with a constant separation that can be stamped next to each other in any order to fill large areas without sampling them. All tiles share the border of a single toroidal tile and only differ by their interior, which keeps the separation valid across the seams. Tiles are laid out on a grid aligned with the origin and picked from the tile coordinates and a seed, so filling adjacent areas gives seamless results.
+class PoissonDiskTileSet {
+public:
+	PoissonDiskTileSet() : mSeparation( 0.0f ), mTileSize( 0.0f ) {}
+	//! builds \a numTiles tiles of \a tileSize width with a minimum \a separation, using the options k, candidate mode and seed, the other options being ignored. The tile size is at least four times the separation.
+	PoissonDiskTileSet( float separation, float tileSize, size_t numTiles = 8, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	
+	//! returns the points of the tiles covering \a area, points lying on the upper edges excluded. \a seed selects which tile is used at each location.
+	std::vector<glm::vec2> fill( const ci::Rectf &area, uint32_t seed = 0 ) const;
+	//! appends the points of the tiles covering \a area to \a output, points lying on the upper edges excluded. \a seed selects which tile is used at each location.
+	void fill( const ci::Rectf &area, std::vector<glm::vec2> *output, uint32_t seed = 0 ) const;
+	
+	//! writes the tile set to \a stream in a native endian binary format
+	void write( std::ostream &stream ) const;
+	//! reads a tile set written by write(), returns an empty tile set if \a stream doesn't contain a valid one
+	static PoissonDiskTileSet read( std::istream &stream );
+	
+	//! returns the minimum separation of the points of the tiles
+	float	getSeparation() const { return mSeparation; }
+	//! returns the width of the tiles
+	float	getTileSize() const { return mTileSize; }
+	//! returns the number of tiles
+	size_t	getNumTiles() const { return mOffsets.empty() ? 0 : mOffsets.size() - 1; }
+	//! returns the points of the tile \a index, relative to its upper left corner
+	const glm::vec2* getTilePoints( size_t index ) const { return mPoints.data() + mOffsets[index]; }
+	//! returns the number of points of the tile \a index
+	size_t	getTileNumPoints( size_t index ) const { return mOffsets[index + 1] - mOffsets[index]; }
+	
+protected:
+	float					mSeparation;
+	float					mTileSize;
+	std::vector<glm::vec2>	mPoints; // points of all the tiles relative to their upper left corner
+	std::vector<uint32_t>	mOffsets; // first point of each tile, followed by the total number of points
+};
+
+// Chunked Poisson Disk Distribution
+
+//! Samples an unbounded 2D world chunk by chunk. Any chunk can be generated on demand, in any order and from any thread, and always gives the same points for a given world seed. Chunks are sampled in four phases like the tiled distribution: a chunk only depends on the neighboring chunks of lower phases, whose points seed its active list and keep the separation valid across the chunk edges. The borders of the recently sampled chunks are cached so that their neighbors don't have to sample them again.
+class PoissonDiskChunkSampler {
+public:
+	//! creates a sampler of square chunks of \a chunkSize width with a minimum \a separation
+	PoissonDiskChunkSampler( float separation, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! creates a sampler of square chunks of \a chunkSize width with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. \a distFunction needs to be thread-safe to sample chunks concurrently.
+	PoissonDiskChunkSampler( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! creates a sampler of square chunks of \a chunkSize width within bounds defined by \a boundsFunction with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. Both functions need to be thread-safe to sample chunks concurrently.
+	PoissonDiskChunkSampler( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, float chunkSize, uint32_t worldSeed, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	
+	//! returns the points of the chunk at \a coords. Thread-safe.
+	std::vector<glm::vec2> getChunk( const glm::ivec2 &coords );
+	
+	//! returns the bounds of the chunk at \a coords
+	ci::Rectf	getChunkBounds( const glm::ivec2 &coords ) const;
+	//! returns the coordinates of the chunk containing \a p
+	glm::ivec2	getChunkCoords( const glm::vec2 &p ) const;
+	//! returns the width of the chunks. Chunks are always at least twice the maximum separation.
+	float		getChunkSize() const { return mChunkSize; }
+	//! returns the seed of the world
+	uint32_t	getWorldSeed() const { return mWorldSeed; }
+	
+	//! sets the number of chunk borders kept in the cache. Defaults to 256.
+	void		setCacheSize( size_t size );
+	//! returns the number of chunk borders kept in the cache
+	size_t		getCacheSize() const { return mCacheSize; }
+	//! removes all the chunk borders from the cache
+	void		clearCache();
+	
+protected:
+	using BorderRef = std::shared_ptr<const std::vector<glm::vec2>>;
+	
+	//! samples the chunk at \a coords in \a output and returns its cached border
+	BorderRef	sampleChunk( const glm::ivec2 &coords, std::vector<glm::vec2> *output );
+	//! returns the border of the chunk at \a coords, sampling the chunk if it isn't cached
+	BorderRef	getBorder( const glm::ivec2 &coords );
+	
+	std::function<float(const glm::vec2&)>	mDistFunction;
+	std::function<bool(const glm::vec2&)>	mBoundsFunction;
+	float				mMinSeparation, mMaxSeparation;
+	float				mChunkSize;
+	uint32_t			mWorldSeed;
+	PoissonDiskOptions	mOptions;
+	
+	// least recently used first cache of the chunk borders
+	using CacheEntry = std::pair<uint64_t, BorderRef>;
+	std::mutex			mCacheMutex;
+	size_t				mCacheSize;
+	std::list<CacheEntry> mCache;
+	std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> mCacheMap;
+};
+
+// Implementation details
+
+namespace poisson_detail {
+	template<typename VecT> struct GridTraits;
+	template<> struct GridTraits<glm::vec2> { using BoundsT = ci::Rectf; using IVecT = glm::ivec2; static const int kDimensions = 2; };
+	template<> struct GridTraits<glm::vec3> { using BoundsT = ci::AxisAlignedBox; using IVecT = glm::ivec3; static const int kDimensions = 3; };
+	
+	//! Flat acceleration grid in 2 or 3 dimensions. Each cell stores up to mCellCapacity point indices inline, points that don't fit go to a small overflow list sorted by cell index. The coordinates of the points stored in each slot are duplicated in a structure of arrays so that a row of cells can be tested with SIMD instructions, which can be disabled by defining POISSON_DISK_NO_SIMD.
+	template<typename VecT>
+	class Grid {
+	public:
+		using PointT	= VecT;
+		using BoundsT	= typename GridTraits<VecT>::BoundsT;
+		
+		Grid();
+		Grid( const BoundsT &bounds, float cellSize, uint32_t cellCapacity = 1 );
+		
+		//! sets the stats whose query counters are incremented by hasNeighbors when compiled with POISSON_DISK_STATS defined
+		void setStats( PoissonDiskStats *stats ) { mStats = stats; }
+		
+		//! adds a point to the grid and returns its index. Points outside of the grid bounds are stored but can't be found by hasNeighbors.
+		int32_t add( const VecT &position );
+		//! returns whether there's a point closer than \a radius to \a p
+		bool hasNeighbors( const VecT &p, float radius ) const;
+		//! writes to \a results whether each of the \a count \a points has a point of the grid closer than \a radius. In 2D, points close to each other, like the candidates around an active point, share the points of the union of their windows, gathered once and tested with whole vectors. Gives the same results as the single point queries.
+		void hasNeighbors( const VecT *points, size_t count, float radius, bool *results ) const;
+		//! removes the point at \a index, the last point of the grid takes its index
+		void remove( int32_t index );
+		//! appends to \a indices the points of the cells overlapping the [ \a min, \a max ] box
+		void getPointsInCells( const VecT &min, const VecT &max, std::vector<int32_t> *indices ) const;
+		//! returns the index of the point nearest to \a p visiting growing rings of cells, or -1 if there's no point of the cells closer than \a maxDistance
+		int32_t getNearest( const VecT &p, float maxDistance ) const;
+		
+		//! returns whether \a p is inside the grid bounds
+		bool contains( const VecT &p ) const;
+		
+		//! returns the point at \a index
+		const VecT& getPoint( int32_t index ) const { return mPoints[index]; }
+		//! returns all the points of the grid in insertion order
+		const std::vector<VecT>& getPoints() const { return mPoints; }
+		//! returns the number of points of the grid
+		size_t getNumPoints() const { return mPoints.size(); }
+		//! returns the width of the cells
+		float getCellSize() const { return mCellSize; }
+		//! moves the points out of the grid, which has to be resized before being used again. The slots are emptied too so that resize() refills all of them.
+		std::vector<VecT> releasePoints() { mCells.clear(); mOverflow.clear(); mSlotCoords[0].clear(); mSlotCoords[1].clear(); mSlotCoords[2].clear(); return std::move( mPoints ); }
+		
+		//! reserves memory for \a numPoints points
+		void reserve( size_t numPoints );
+		
+		//! changes the bounds and layout of the grid and clears it, reusing its memory when possible
+		void resize( const BoundsT &bounds, float cellSize, uint32_t cellCapacity = 1 );
+		void resize( float cellSize, uint32_t cellCapacity = 1 );
+		//! removes all the points, only resetting the cells that were used when the grid is sparse
+		void clear();
+		
+	protected:
+		glm::ivec3 getCellCoords( const VecT &position ) const;
+		//! returns the index of the cell containing \a position or -1 if it is outside of the grid
+		int32_t getCellIndex( const VecT &position ) const;
+		//! tests the \a points against the points of the union of their windows, returns false without writing \a results when the window is too large to be gathered
+		bool hasNeighborsInWindow( const VecT *points, size_t count, float radius, bool *results ) const;
+		void setSlotPosition( size_t slot, const VecT &position );
+		void clearSlots( size_t first, size_t last );
+		
+		std::vector<VecT>			mPoints;
+		std::vector<int32_t>		mCells;
+		std::vector<float>			mSlotCoords[3]; // x, y and z of the point stored in each slot, in 2D z is unused
+		std::vector<glm::ivec2>		mOverflow; // ( cell index, point index ) pairs
+		glm::ivec3					mNumCells; // z is 1 in 2D
+		VecT						mMin, mMax;
+		float						mCellSize, mInvCellSize;
+		uint32_t					mCellCapacity;
+		PoissonDiskStats			*mStats;
+	};
+	
+	//! Acceleration grid for wide ranges of separations. Points are added to a stack of grids whose cells double in size from one level to the next, and each query goes to the level whose cells match its radius. As long as the separation varies smoothly the points around a query have a separation close to its radius, so every query visits a few cells holding a few points wherever it is. Cells store the head of a list of points linked by index, which doesn't limit the number of points per cell.
+	template<typename VecT>
+	class MultiLevelGrid {
+	public:
+		using PointT	= VecT;
+		using BoundsT	= typename GridTraits<VecT>::BoundsT;
+		
+		MultiLevelGrid();
+		MultiLevelGrid( const BoundsT &bounds, float minSeparation, float maxSeparation );
+		
+		//! sets the stats whose query counters are incremented by hasNeighbors when compiled with POISSON_DISK_STATS defined
+		void setStats( PoissonDiskStats *stats ) { mStats = stats; }
+		
+		//! adds a point to every level of the grid and returns its index. Points outside of the grid bounds are stored but can't be found by hasNeighbors.
+		int32_t add( const VecT &position );
+		//! returns whether there's a point closer than \a radius to \a p
+		bool hasNeighbors( const VecT &p, float radius ) const;
+		//! writes to \a results whether each of the \a count \a points has a point of the grid closer than \a radius. In 2D, points close to each other, like the candidates around an active point, share the points of the union of their windows, gathered once and tested with whole vectors. Gives the same results as the single point queries.
+		void hasNeighbors( const VecT *points, size_t count, float radius, bool *results ) const;
+		//! returns whether \a p is inside the grid bounds
+		bool contains( const VecT &p ) const;
+		
+		//! returns the point at \a index
+		const VecT& getPoint( int32_t index ) const { return mPoints[index]; }
+		//! returns all the points of the grid in insertion order
+		const std::vector<VecT>& getPoints() const { return mPoints; }
+		//! returns the number of points of the grid
+		size_t getNumPoints() const { return mPoints.size(); }
+		//! moves the points out of the grid, which has to be resized before being used again
+		std::vector<VecT> releasePoints();
+		
+		//! reserves memory for \a numPoints points, in the current levels and the ones added by the next resizes
+		void reserve( size_t numPoints );
+		//! changes the bounds and separation range of the grid and clears it, reusing its memory when possible
+		void resize( const BoundsT &bounds, float minSeparation, float maxSeparation );
+		//! removes all the points
+		void clear();
+		
+	protected:
+		//! resets the cells of every level without removing the points
+		void clearCells();
+		//! tests the \a points against the points of the union of their windows, returns false without writing \a results when the window is too large to be gathered
+		bool hasNeighborsInWindow( const VecT *points, size_t count, float radius, bool *results ) const;
+		
+		struct Level {
+			glm::ivec3				mNumCells; // z is 1 in 2D
+			float					mCellSize, mInvCellSize;
+			std::vector<int32_t>	mHeads; // first point of each cell
+			std::vector<int32_t>	mNext; // next point of the same cell for each point
+		};
+		
+		std::vector<VecT>	mPoints;
+		std::vector<Level>	mLevels;
+		VecT				mMin, mMax;
+		float				mMinSeparation;
+		size_t				mNumLevels;
+		size_t				mNumReservedPoints;
+		PoissonDiskStats	*mStats;
+	};
+	
+	//! ratio between the maximum and minimum separations above which the multi-level grid is used
+	const float kMultiLevelGridRatio = 4.0f;
+	//! returns whether a range of separations is wide enough to use the multi-level grid
+	inline bool isMultiLevel( float minSeparation, float maxSeparation ) { return maxSeparation > minSeparation * kMultiLevelGridRatio; }
+	
+	//! prepares \a grid for a range of separations
+	template<typename VecT>
+	void setupGrid( Grid<VecT> &grid, const typename GridTraits<VecT>::BoundsT &bounds, float minSeparation, float maxSeparation );
+	template<typename VecT>
+	void setupGrid( MultiLevelGrid<VecT> &grid, const typename GridTraits<VecT>::BoundsT &bounds, float minSeparation, float maxSeparation ) { grid.resize( bounds, minSeparation, maxSeparation ); }
+	
+	//! returns the lower corner of \a bounds
+	inline glm::vec2 getMin( const ci::Rectf &bounds ) { return bounds.getUpperLeft(); }
+	inline glm::vec3 getMin( const ci::AxisAlignedBox &bounds ) { return bounds.getMin(); }
+	//! returns the upper corner of \a bounds
+	inline glm::vec2 getMax( const ci::Rectf &bounds ) { return bounds.getLowerRight(); }
+	inline glm::vec3 getMax( const ci::AxisAlignedBox &bounds ) { return bounds.getMax(); }
+	//! returns whether \a p is inside \a bounds, upper corner included
+	inline bool contains( const ci::Rectf &bounds, const glm::vec2 &p ) { return bounds.contains( p ); }
+	inline bool contains( const ci::AxisAlignedBox &bounds, const glm::vec3 &p )
+	{
+		const glm::vec3 &min = bounds.getMin(), &max = bounds.getMax();
+		return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x <= max.x && p.y <= max.y && p.z <= max.z;
+	}
+	
+	//! returns the cell size used for a range of separations. With a constant separation this is Bridson's r/sqrt(n), which guarantees at most one point per cell. With a variable separation the geometric mean of the range is used so that neither the densest nor the sparsest regions have to walk too many cells or points.
+	float getCellSize( float minSeparation, float maxSeparation, int dimensions = 2 );
+	
+	//! returns the number of points a cell of \a cellSize can hold with a minimum separation of \a minSeparation. Cells with a diagonal shorter than the separation hold a single point, larger cells get a slot for roughly each point of the densest packing.
+	uint32_t getCellCapacity( float cellSize, float minSeparation, int dimensions = 2 );
+	
+	template<typename VecT>
+	void setupGrid( Grid<VecT> &grid, const typename GridTraits<VecT>::BoundsT &bounds, float minSeparation, float maxSeparation )
+	{
+		float cellSize = getCellSize( minSeparation, maxSeparation, GridTraits<VecT>::kDimensions );
+		grid.resize( bounds, cellSize, getCellCapacity( cellSize, minSeparation, GridTraits<VecT>::kDimensions ) );
+	}
+	
+	//! returns an upper bound of the number of points with a \a minSeparation that fit in \a bounds, based on the density of a hexagonal packing
+	size_t getMaxNumPoints( const ci::Rectf &bounds, float minSeparation );
+	//! returns an upper bound of the number of points with a \a minSeparation that fit in \a bounds, based on the density of a face-centered cubic packing
+	size_t getMaxNumPoints( const ci::AxisAlignedBox &bounds, float minSeparation );
+	
+	//! estimates the range of separations returned by \a distFunction by probing it on a coarse lattice covering \a bounds. The maximum is padded to make up for the peaks the probes miss, and a warning is logged when \a options use tiled or dart throwing sampling which rely on it.
+	glm::vec2 getSeparationRange( const std::function<float(const glm::vec2&)> &distFunction, const ci::Rectf &bounds, const PoissonDiskOptions &options );
+	glm::vec2 getSeparationRange( const std::function<float(const glm::vec3&)> &distFunction, const ci::AxisAlignedBox &bounds, const PoissonDiskOptions &options );
+	
+	//! returns the options seed or a non-deterministic one if none was provided
+	uint32_t getSeed( const PoissonDiskOptions &options );
+	
+	//! returns a random integer in the [0, \a max) range
+	template<typename URBG>
+	inline int randInt( URBG &rng, size_t max )
+	{
+		return static_cast<int>( std::uniform_int_distribution<size_t>( 0, max - 1 )( rng ) );
+	}
+	//! returns a random float in the [0,1) range built from 24 random bits
+	template<typename URBG>
+	inline float randFloat( URBG &rng )
+	{
+		static_assert( URBG::max() - URBG::min() >= 0xFFFFFF, "The random engine needs to provide at least 24 random bits" );
+		return static_cast<float>( static_cast<uint64_t>( rng() - URBG::min() ) & 0xFFFFFF ) * ( 1.0f / 16777216.0f );
+	}
+	
+	//! returns a table of 256 unit vectors evenly distributed around the circle
+	const glm::vec2* getCircleDirections();
+	//! returns a table of 256 unit vectors evenly distributed on the sphere
+	const glm::vec3* getSphereDirections();
+	
+	//! Rotation of the direction table, stored as the rotated axes
+	template<typename VecT>
+	struct DirectionRotation {
+		//! returns \a direction rotated
+		VecT rotate( const VecT &direction ) const
+		{
+			VecT result = direction.x * mAxes[0];
+			for( int i = 1; i < GridTraits<VecT>::kDimensions; i++ ) {
+				result += direction[i] * mAxes[i];
+			}
+			return result;
+		}
+		
+		VecT mAxes[GridTraits<VecT>::kDimensions];
+	};
+	
+	//! returns a uniformly random rotation of the plane
+	template<typename URBG>
+	inline DirectionRotation<glm::vec2> randDirectionRotation( URBG &rng, const glm::vec2 & )
+	{
+		float angle = randFloat( rng ) * 2.0f * (float) M_PI;
+		float c = std::cos( angle ), s = std::sin( angle );
+		return DirectionRotation<glm::vec2>{ { glm::vec2( c, s ), glm::vec2( -s, c ) } };
+	}
+	//! returns a uniformly random rotation of the space, built from a uniform unit quaternion
+	template<typename URBG>
+	inline DirectionRotation<glm::vec3> randDirectionRotation( URBG &rng, const glm::vec3 & )
+	{
+		float u0 = randFloat( rng ), a1 = randFloat( rng ) * 2.0f * (float) M_PI, a2 = randFloat( rng ) * 2.0f * (float) M_PI;
+		float r1 = std::sqrt( 1.0f - u0 ), r2 = std::sqrt( u0 );
+		float x = r1 * std::sin( a1 ), y = r1 * std::cos( a1 ), z = r2 * std::sin( a2 ), w = r2 * std::cos( a2 );
+		return DirectionRotation<glm::vec3>{ {
+			glm::vec3( 1.0f - 2.0f * ( y * y + z * z ), 2.0f * ( x * y + z * w ), 2.0f * ( x * z - y * w ) ),
+			glm::vec3( 2.0f * ( x * y - z * w ), 1.0f - 2.0f * ( x * x + z * z ), 2.0f * ( y * z + x * w ) ),
+			glm::vec3( 2.0f * ( x * z + y * w ), 2.0f * ( y * z - x * w ), 1.0f - 2.0f * ( x * x + y * y ) )
+		} };
+	}
+	
+	//! returns a random point in the annulus between \a radius and 2 * \a radius around \a center. The direction table is turned by \a rotation, which is drawn once per active point.
+	template<typename URBG>
+	inline glm::vec2 randAnnulusPoint( URBG &rng, const glm::vec2 &center, float radius, const DirectionRotation<glm::vec2> &rotation, PoissonDiskOptions::CandidateMode mode )
+	{
+		if( mode == PoissonDiskOptions::DIRECTION_TABLE ) {
+			// the radius squared is uniform between r^2 and 4r^2 so that candidates are uniform in area
+			glm::vec2 direction = rotation.rotate( getCircleDirections()[ static_cast<size_t>( rng() - URBG::min() ) & 255 ] );
+			return center + direction * ( radius * std::sqrt( 1.0f + 3.0f * randFloat( rng ) ) );
+		}
+		
+		// rejection sampling in the annulus bounding square, 59% of the samples are accepted
+		float sqRadius = radius * radius;
+		while( true ) {
+			glm::vec2 offset = glm::vec2( randFloat( rng ), randFloat( rng ) ) * ( 4.0f * radius ) - glm::vec2( 2.0f * radius );
+			float sqLength = glm::length2( offset );
+			if( sqLength >= sqRadius && sqLength < 4.0f * sqRadius ) {
+				return center + offset;
+			}
+		}
+	}
+	
+	//! returns a random point in the spherical shell between \a radius and 2 * \a radius around \a center. The direction table is turned by \a rotation, which is drawn once per active point.
+	template<typename URBG>
+	inline glm::vec3 randAnnulusPoint( URBG &rng, const glm::vec3 &center, float radius, const DirectionRotation<glm::vec3> &rotation, PoissonDiskOptions::CandidateMode mode )
+	{
+		if( mode == PoissonDiskOptions::DIRECTION_TABLE ) {
+			// the radius cubed is uniform between r^3 and 8r^3 so that candidates are uniform in volume
+			glm::vec3 direction = rotation.rotate( getSphereDirections()[ static_cast<size_t>( rng() - URBG::min() ) & 255 ] );
+			return center + direction * ( radius * std::cbrt( 1.0f + 7.0f * randFloat( rng ) ) );
+		}
+		
+		// rejection sampling in the shell bounding cube, 46% of the samples are accepted
+		float sqRadius = radius * radius;
+		while( true ) {
+			glm::vec3 offset = glm::vec3( randFloat( rng ), randFloat( rng ), randFloat( rng ) ) * ( 4.0f * radius ) - glm::vec3( 2.0f * radius );
+			float sqLength = glm::length2( offset );
+			if( sqLength >= sqRadius && sqLength < 4.0f * sqRadius ) {
+				return center + offset;
+			}
+		}
+	}
+	
+	//! Constant separation policy
+	struct ConstantSeparation {
+		template<typename VecT>
+		float operator()( const VecT & ) const { return mSeparation; }
+		float mSeparation;
+	};
+	
+	//! Policy used when there's no bounds function, only the grid bounds are tested
+	struct NoBoundsFunction {
+		template<typename VecT>
+		bool operator()( const VecT & ) const { return true; }
+	};
+	
+	//! Separation policy reading a density channel stretched over an area
+	class ChannelSeparation {
+	public:
+		ChannelSeparation( const ci::Channel32f &density, const ci::Rectf &area, float minSeparation, float maxSeparation );
+		
+		float operator()( const glm::vec2 &p ) const
+		{
+			// bilinear interpolation between the centers of the texels
+			glm::vec2 t	= glm::clamp( ( p - mMin ) * mScale - glm::vec2( 0.5f ), glm::vec2( 0.0f ), mMaxCoords );
+			int x0		= static_cast<int>( t.x );
+			int y0		= static_cast<int>( t.y );
+			int x1		= glm::min( x0 + 1, mSize.x - 1 );
+			int y1		= glm::min( y0 + 1, mSize.y - 1 );
+			float fx	= t.x - x0;
+			float fy	= t.y - y0;
+			float top	= getTexel( x0, y0 ) + ( getTexel( x1, y0 ) - getTexel( x0, y0 ) ) * fx;
+			float bottom = getTexel( x0, y1 ) + ( getTexel( x1, y1 ) - getTexel( x0, y1 ) ) * fx;
+			float d		= glm::clamp( top + ( bottom - top ) * fy, 0.0f, 1.0f );
+			return mMaxSeparation + ( mMinSeparation - mMaxSeparation ) * d;
+		}
+		
+	protected:
+		float getTexel( int x, int y ) const { return reinterpret_cast<const float*>( mData + y * mRowBytes )[x * mIncrement]; }
+		
+		const uint8_t	*mData;
+		ptrdiff_t		mRowBytes;
+		int				mIncrement;
+		glm::ivec2		mSize;
+		glm::vec2		mMin, mScale, mMaxCoords;
+		float			mMinSeparation, mMaxSeparation;
+	};
+	
+	//! Bounds policy reading a mask channel stretched over an area, texels of at least 128 being inside. The mask is summarized in cells that are either fully outside, fully inside or on an edge, only the last ones reading the mask.
+	class ChannelMask {
+	public:
+		enum CellState : uint8_t { CELL_OUTSIDE, CELL_INSIDE, CELL_EDGE };
+		
+		//! builds the cells of \a cellSize width from a summed area table of \a mask
+		ChannelMask( const ci::Channel8u &mask, const ci::Rectf &area, float cellSize );
+		
+		bool operator()( const glm::vec2 &p ) const
+		{
+			glm::ivec2 c = getCellCoords( p );
+			if( c.x < 0 || c.y < 0 || c.x >= mNumCells.x || c.y >= mNumCells.y ) {
+				return false;
+			}
+			uint8_t state = mCellStates[c.x + c.y * mNumCells.x];
+			return state == CELL_EDGE ? isTexelInside( getTexelCoords( p ) ) : state == CELL_INSIDE;
+		}
+		
+		//! returns the coordinates of the cell containing \a p
+		glm::ivec2	getCellCoords( const glm::vec2 &p ) const { return glm::ivec2( glm::floor( ( p - mMin ) * mInvCellSize ) ); }
+		//! returns the number of cells
+		glm::ivec2	getNumCells() const { return mNumCells; }
+		//! returns in \a p a point of the cell at \a coords inside the mask, its center when the cell is fully inside. Returns false if the whole cell is outside.
+		bool		getCellPoint( const glm::ivec2 &coords, glm::vec2 *p ) const;
+		
+	protected:
+		glm::ivec2	getTexelCoords( const glm::vec2 &p ) const { return glm::clamp( glm::ivec2( ( p - mMin ) * mScale ), glm::ivec2( 0 ), mSize - glm::ivec2( 1 ) ); }
+		bool		isTexelInside( const glm::ivec2 &t ) const { return mData[t.y * mRowBytes + t.x * mIncrement] >= 128; }
+		
+		const uint8_t			*mData;
+		ptrdiff_t				mRowBytes;
+		int						mIncrement;
+		glm::ivec2				mSize, mNumCells;
+		glm::vec2				mMin, mScale;
+		float					mCellSize, mInvCellSize;
+		std::vector<uint8_t>	mCellStates;
+	};
+	
+	//! adds \a stats to \a target if it isn't null, under a lock as tiles can finish concurrently
+	void mergeStats( PoissonDiskStats *target, const PoissonDiskStats &stats );
+	//! returns a monotonic time in seconds used by the stats timings and the time budget
+	inline double getTime() { return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+	
+	//! Point count and time budgets of the options, shared by every active list of a distribution. Thread-safe so that tiles sampled concurrently stop together.
+	class SamplingBudget {
+	public:
+		explicit SamplingBudget( const PoissonDiskOptions &options );
+		
+		//! returns whether the distribution has to stop, either because it reached the maximum number of points or ran out of time
+		bool isExhausted()
+		{
+			if( mIsExhausted.load( std::memory_order_relaxed ) ) {
+				return true;
+			}
+			if( mDeadline > 0.0 && getTime() >= mDeadline ) {
+				mIsExhausted.store( true, std::memory_order_relaxed );
+				return true;
+			}
+			return false;
+		}
+		//! reserves room for a new point and returns whether there was any left
+		bool addPoint()
+		{
+			if( ! mMaxPoints ) {
+				return true;
+			}
+			if( mNumPoints.fetch_add( 1, std::memory_order_relaxed ) < mMaxPoints ) {
+				return true;
+			}
+			mIsExhausted.store( true, std::memory_order_relaxed );
+			return false;
+		}
+		//! counts points that are always part of the distribution, ie. the initial points
+		void addPoints( size_t count ) { mNumPoints.fetch_add( count, std::memory_order_relaxed ); }
+		
+	protected:
+		size_t				mMaxPoints;
+		double				mDeadline;
+		std::atomic<size_t>	mNumPoints;
+		std::atomic<bool>	mIsExhausted;
+	};
+	
+	//! number of candidates generated and tested against the grid at once
+	const int kCandidateBatchSize = 32;
+	//! weight of the last active point in the average number of accepted points that drives adaptive k
+	const float kAdaptiveKSmoothing = 1.0f / 4.0f;
+	
+	//! processActiveList kernel for a number of candidates per point known at compile time, or read from the options when \a FixedK is 0. A fixed k sizes the batches to the candidates actually drawn and lets the compiler unroll their generation.
+	template<int FixedK, typename GridT, typename URBG, typename DistFn, typename BoundsFn, typename AcceptFn>
+	void processActiveListK( GridT &grid, std::vector<int32_t> &processingList, URBG &rng, const DistFn &distFunction, const BoundsFn &boundsFunction, const typename GridT::BoundsT &bounds, const PoissonDiskOptions &options, SamplingBudget &budget, const AcceptFn &onAccepted )
+	{
+		using VecT = typename GridT::PointT;
+		static const int kBatchSize = FixedK > 0 && FixedK < kCandidateBatchSize ? FixedK : kCandidateBatchSize;
+		
+		// count locally and merge once, tiles sampled concurrently share the same stats
+		POISSON_DISK_STAT( PoissonDiskStats stats; )
+		POISSON_DISK_STAT( double startTime = getTime(); )
+		POISSON_DISK_STAT( stats.mPeakActiveListSize = processingList.size(); )
+		POISSON_DISK_STAT( grid.setStats( options.getStats() ? &stats : nullptr ); )
+		
+		// acceptance rate over the current window of candidates, and average number of points accepted per active point for adaptive k
+		size_t numWindowCandidates	= 0;
+		size_t numWindowAccepted	= 0;
+		float numAcceptedPerPoint	= 1.0f;
+		bool isFull					= false;
+		
+		// while there's points in the processing list and budget left
+		while( processingList.size() && ! isFull && ! budget.isExhausted() ){
+			
+			// pick a random point in the processing list
+			int randPoint = randInt( rng, processingList.size() );
+			VecT center = grid.getPoint( processingList[randPoint] );
+			
+			// remove it, either by shifting the rest of the list to keep it ordered or by replacing it with the last point
+			if( options.isStableOrder() ){
+				processingList.erase( processingList.begin() + randPoint );
+			}
+			else {
+				processingList[randPoint] = processingList.back();
+				processingList.pop_back();
+			}
+			
+			// get the current min distance
+			float dist = distFunction( center );
+			
+			// the direction table is rotated randomly around each active point so that the candidates of different points don't share the same rays
+			DirectionRotation<VecT> rotation;
+			if( options.getCandidateMode() == PoissonDiskOptions::DIRECTION_TABLE ) {
+				rotation = randDirectionRotation( rng, center );
+			}
+			
+			// spawn k points in an anulus around that point
+			// the higher k is, the higher the packing will be and slower the algorithm
+			int k = FixedK ? FixedK : options.getK();
+			if( ! FixedK && options.isAdaptiveK() ) {
+				k = glm::clamp( static_cast<int>( std::ceil( k * numAcceptedPerPoint ) ), options.getMinK(), k );
+			}
+			size_t numAccepted = 0;
+			for( int first = 0; first < k && ! isFull; first += kBatchSize ){
+				// generate a batch of candidates and keep the ones that are in the bounds
+				VecT candidates[kBatchSize];
+				bool hasNeighbors[kBatchSize];
+				int numCandidates = 0;
+				for( int i = first; i < glm::min( first + kBatchSize, k ); i++ ){
+					VecT newPoint = randAnnulusPoint( rng, center, dist, rotation, options.getCandidateMode() );
+					POISSON_DISK_STAT( stats.mNumCandidates++; )
+					if( ! contains( bounds, newPoint ) ){
+						POISSON_DISK_STAT( stats.mNumOutOfBounds++; )
+					}
+					else if( ! boundsFunction( newPoint ) ){
+						POISSON_DISK_STAT( stats.mNumRejectedByBoundsFunction++; )
+					}
+					else {
+						candidates[numCandidates++] = newPoint;
+					}
+				}
+				
+				// test the whole batch against the grid, then against the points accepted from this batch
+				grid.hasNeighbors( candidates, numCandidates, dist, hasNeighbors );
+				int32_t firstAccepted = static_cast<int32_t>( grid.getNumPoints() );
+				for( int i = 0; i < numCandidates; i++ ){
+					bool isValid = ! hasNeighbors[i];
+					for( int32_t j = firstAccepted; isValid && j < static_cast<int32_t>( grid.getNumPoints() ); j++ ){
+						isValid = glm::length2( candidates[i] - grid.getPoint( j ) ) >= dist * dist;
+					}
+					
+					// if the point has no close neighbors add it to the grid and the processing list
+					if( isValid && ! budget.addPoint() ){
+						isFull = true;
+						break;
+					}
+					if( isValid ){
+						int32_t index = grid.add( candidates[i] );
+						numAccepted++;
+						processingList.push_back( index );
+						onAccepted( index );
+						POISSON_DISK_STAT( stats.mNumAccepted++; )
+						POISSON_DISK_STAT( stats.mPeakActiveListSize = glm::max( stats.mPeakActiveListSize, processingList.size() ); )
+					}
+					else {
+						POISSON_DISK_STAT( stats.mNumRejectedByNeighbors++; )
+					}
+				}
+			}
+			
+			// stop when the front doesn't accept enough of its candidates
+			if( options.getMinAcceptanceRate() > 0.0f ) {
+				numWindowCandidates	+= k;
+				numWindowAccepted	+= numAccepted;
+				if( numWindowCandidates >= options.getAcceptanceWindow() ) {
+					if( numWindowAccepted < options.getMinAcceptanceRate() * numWindowCandidates ) {
+						processingList.clear();
+						break;
+					}
+					numWindowCandidates = numWindowAccepted = 0;
+				}
+			}
+			numAcceptedPerPoint += ( numAccepted - numAcceptedPerPoint ) * kAdaptiveKSmoothing;
+		}
+		
+		POISSON_DISK_STAT( grid.setStats( nullptr ); )
+		POISSON_DISK_STAT( stats.mSamplingTime = getTime() - startTime; )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+	}
+	
+	//! processes the active \a processingList, made of \a grid point indices, until it is empty. Candidates are generated by batches whose neighbor queries run back to back, which gives the same result as testing them one after the other. Accepted candidates are added to the grid and passed to \a onAccepted by index. Candidates have to be inside \a bounds and pass \a boundsFunction. The common values of k use kernels specialized at compile time, which can be disabled by defining POISSON_DISK_NO_FIXED_K.
+	template<typename GridT, typename URBG, typename DistFn, typename BoundsFn, typename AcceptFn>
+	void processActiveList( GridT &grid, std::vector<int32_t> &processingList, URBG &rng, const DistFn &distFunction, const BoundsFn &boundsFunction, const typename GridT::BoundsT &bounds, const PoissonDiskOptions &options, SamplingBudget &budget, const AcceptFn &onAccepted )
+	{
+#if ! defined( POISSON_DISK_NO_FIXED_K )
+		if( ! options.isAdaptiveK() ) {
+			switch( options.getK() ) {
+				case 8:		processActiveListK<8>( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted ); return;
+				case 16:	processActiveListK<16>( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted ); return;
+				case 30:	processActiveListK<30>( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted ); return;
+				case 64:	processActiveListK<64>( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted ); return;
+				default:	break;
+			}
+		}
+#endif
+		processActiveListK<0>( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted );
+	}
+	
+	//! returns whether \a p can start a distribution when no initial point is provided. Any point can, except with masks that know where the valid points are.
+	template<typename BoundsFn, typename VecT>
+	bool isValidSeed( const BoundsFn &, const VecT & ) { return true; }
+	inline bool isValidSeed( const ChannelMask &mask, const glm::vec2 &p ) { return mask( p ); }
+	
+	//! restarts the distribution from the parts of \a bounds the active list couldn't reach. Only masks know where those are, other bounds functions don't do anything.
+	template<typename GridT, typename URBG, typename DistFn, typename BoundsFn, typename AcceptFn>
+	void seedUnreachedRegions( GridT &, std::vector<int32_t> &, URBG &, const DistFn &, const BoundsFn &, const typename GridT::BoundsT &, const PoissonDiskOptions &, SamplingBudget &, const AcceptFn & ) {}
+	template<typename GridT, typename URBG, typename DistFn, typename AcceptFn>
+	void seedUnreachedRegions( GridT &grid, std::vector<int32_t> &processingList, URBG &rng, const DistFn &distFunction, const ChannelMask &mask, const ci::Rectf &bounds, const PoissonDiskOptions &options, SamplingBudget &budget, const AcceptFn &onAccepted )
+	{
+		// any cell of the mask that doesn't have a point around it starts a new front
+		glm::ivec2 minCell	= glm::max( mask.getCellCoords( getMin( bounds ) ), glm::ivec2( 0 ) );
+		glm::ivec2 maxCell	= glm::min( mask.getCellCoords( getMax( bounds ) ) + glm::ivec2( 1 ), mask.getNumCells() );
+		glm::vec2 p;
+		for( int y = minCell.y; y < maxCell.y && ! budget.isExhausted(); y++ ) {
+			for( int x = minCell.x; x < maxCell.x; x++ ) {
+				if( mask.getCellPoint( glm::ivec2( x, y ), &p ) && contains( bounds, p ) && ! grid.hasNeighbors( p, distFunction( p ) ) ) {
+					if( ! budget.addPoint() ) {
+						return;
+					}
+					int32_t index = grid.add( p );
+					processingList.push_back( index );
+					onAccepted( index );
+					processActiveList( grid, processingList, rng, distFunction, mask, bounds, options, budget, onAccepted );
+				}
+			}
+		}
+	}
+	
+	//! Sink used when the points are only returned
+	struct NoSink {
+		template<typename VecT>
+		void operator()( const VecT *, size_t ) const {}
+	};
+	
+	//! returns the number of threads that options.getNumThreads() stands for, the hardware concurrency when it is 0 or when tasks go to the options executor
+	size_t getNumWorkers( const PoissonDiskOptions &options );
+	//! returns \a options without threads nor executor, for the distributions sampled serially
+	inline PoissonDiskOptions getSerialOptions( const PoissonDiskOptions &options ) { return PoissonDiskOptions( options ).numThreads( 1 ).executor( PoissonDiskOptions::ParallelFor() ); }
+	//! runs \a count tasks on the options executor or on up to options.getNumThreads() threads
+	void parallelFor( size_t count, const std::function<void( size_t )> &task, const PoissonDiskOptions &options );
+	
+	//! returns a seed derived from \a seed and \a index, used to give each tile its own random stream
+	inline uint32_t hashSeed( uint32_t seed, uint32_t index )
+	{
+		uint64_t z = ( static_cast<uint64_t>( seed ) << 32 | index ) + 0x9e3779b97f4a7c15ULL;
+		z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+		z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+		return static_cast<uint32_t>( z ^ ( z >> 31 ) );
+	}
+	
+	//! converts \a value to an IEEE half float, rounding to the nearest
+	inline uint16_t floatToHalf( float value )
+	{
+		uint32_t bits;
+		std::memcpy( &bits, &value, sizeof( bits ) );
+		uint32_t sign		= ( bits >> 16 ) & 0x8000;
+		int32_t exponent	= static_cast<int32_t>( ( bits >> 23 ) & 0xff ) - 127 + 15;
+		uint32_t mantissa	= bits & 0x7fffff;
+		if( exponent <= 0 ) {
+			// subnormals, or zero when too small
+			if( exponent < -10 ) {
+				return static_cast<uint16_t>( sign );
+			}
+			mantissa = ( mantissa | 0x800000 ) >> ( 1 - exponent );
+			return static_cast<uint16_t>( sign | ( ( mantissa + 0x1000 ) >> 13 ) );
+		}
+		if( exponent >= 31 ) {
+			// overflows and infinites saturate to infinity, nans stay nans
+			return static_cast<uint16_t>( sign | 0x7c00 | ( ( bits & 0x7fffffff ) > 0x7f800000 ? 0x200 : 0 ) );
+		}
+		// the rounding can carry into the exponent, which gives the right result
+		return static_cast<uint16_t>( ( sign | static_cast<uint32_t>( exponent ) << 10 | mantissa >> 13 ) + ( ( mantissa >> 12 ) & 1 ) );
+	}
+	//! converts the IEEE half float \a half to a float
+	inline float halfToFloat( uint16_t half )
+	{
+		uint32_t sign		= static_cast<uint32_t>( half & 0x8000 ) << 16;
+		uint32_t exponent	= ( half >> 10 ) & 0x1f;
+		uint32_t mantissa	= half & 0x3ff;
+		uint32_t bits;
+		if( exponent == 0 ) {
+			// zero and subnormals
+			float value = std::ldexp( static_cast<float>( mantissa ), -24 );
+			return sign ? -value : value;
+		}
+		else if( exponent == 31 ) {
+			bits = sign | 0x7f800000 | mantissa << 13;
+		}
+		else {
+			bits = sign | ( exponent + 127 - 15 ) << 23 | mantissa << 13;
+		}
+		float value;
+		std::memcpy( &value, &bits, sizeof( value ) );
+		return value;
+	}
+	
+	//! writes the 16-bit fixed point coordinates of \a p relative to \a bounds to \a coords
+	inline void toUnorm16( const glm::vec2 &p, const ci::Rectf &bounds, uint16_t *coords )
+	{
+		glm::vec2 q	= glm::clamp( glm::floor( ( p - bounds.getUpperLeft() ) / glm::max( bounds.getSize(), glm::vec2( 1e-30f ) ) * 65535.0f + glm::vec2( 0.5f ) ), glm::vec2( 0.0f ), glm::vec2( 65535.0f ) );
+		coords[0]	= static_cast<uint16_t>( q.x );
+		coords[1]	= static_cast<uint16_t>( q.y );
+	}
+	//! returns the point of the 16-bit fixed point \a coords relative to \a bounds
+	inline glm::vec2 fromUnorm16( const uint16_t *coords, const ci::Rectf &bounds ) { return bounds.getUpperLeft() + glm::vec2( coords[0], coords[1] ) * bounds.getSize() / 65535.0f; }
+	
+	//! converts between ci::Rectf / ci::AxisAlignedBox and their corners
+	inline ci::Rectf makeBounds( const glm::vec2 &min, const glm::vec2 &max ) { return ci::Rectf( min, max ); }
+	inline ci::AxisAlignedBox makeBounds( const glm::vec3 &min, const glm::vec3 &max ) { return ci::AxisAlignedBox( min, max ); }
+	inline glm::ivec3 toIVec3( const glm::ivec2 &v ) { return glm::ivec3( v.x, v.y, 0 ); }
+	inline glm::ivec3 toIVec3( const glm::ivec3 &v ) { return v; }
+	inline glm::vec2 toVec( const glm::ivec3 &v, const glm::vec2 & ) { return glm::vec2( v.x, v.y ); }
+	inline glm::vec3 toVec( const glm::ivec3 &v, const glm::vec3 & ) { return glm::vec3( v.x, v.y, v.z ); }
+	
+	//! returns a random point inside \a bounds
+	template<typename URBG>
+	inline glm::vec2 randPoint( URBG &rng, const ci::Rectf &bounds ) { return getMin( bounds ) + ( getMax( bounds ) - getMin( bounds ) ) * glm::vec2( randFloat( rng ), randFloat( rng ) ); }
+	template<typename URBG>
+	inline glm::vec3 randPoint( URBG &rng, const ci::AxisAlignedBox &bounds ) { return getMin( bounds ) + ( getMax( bounds ) - getMin( bounds ) ) * glm::vec3( randFloat( rng ), randFloat( rng ), randFloat( rng ) ); }
+	
+	//! fills \a ranks with the position along the \a order curve of each cell of a grid of \a numCells, indexed as x + ( y + z * numCells.y ) * numCells.x. 2D grids have a single layer.
+	void getCurveRanks( const glm::ivec3 &numCells, PoissonDiskOptions::Order order, std::vector<uint32_t> *ranks );
+	
+	//! sorts \a points along the \a order curve. Points are bucketed in cells of about one point, whose ranks along the curve are enumerated without comparisons, then scattered by rank.
+	template<typename VecT>
+	void sortAlongCurve( std::vector<VecT> *points, PoissonDiskOptions::Order order )
+	{
+		using IVecT = typename GridTraits<VecT>::IVecT;
+		const int kDimensions = GridTraits<VecT>::kDimensions;
+		if( order == PoissonDiskOptions::ACCEPTANCE_ORDER || points->size() < 2 ) {
+			return;
+		}
+		
+		// cells hold about one point over the axes the points span, initial points can lie anywhere. Axes a thousand times
+		// thinner than the widest one, like the float noise of points sampled on a plane, don't count as spanned
+		VecT min = points->front(), max = points->front();
+		for( const auto &p : *points ) {
+			min = glm::min( min, p );
+			max = glm::max( max, p );
+		}
+		VecT size		= max - min;
+		float maxSize	= 0.0f;
+		for( int i = 0; i < kDimensions; i++ ) {
+			maxSize = glm::max( maxSize, size[i] );
+		}
+		float volume	= 1.0f;
+		int numAxes		= 0;
+		for( int i = 0; i < kDimensions; i++ ) {
+			if( size[i] > 0.0f && size[i] >= maxSize * 1e-3f ) {
+				volume *= size[i];
+				numAxes++;
+			}
+		}
+		if( ! numAxes ) {
+			return;
+		}
+		
+		// the axes that aren't spanned, or only partly, still get at least one cell, grow the cells until there's at most
+		// two per point
+		float cellSize	= std::pow( volume / points->size(), 1.0f / numAxes );
+		IVecT numCells;
+		for( ;; cellSize *= 1.25f ) {
+			numCells			= glm::clamp( IVecT( glm::ceil( size / cellSize ) ), IVecT( 1 ), IVecT( 1 << 20 ) );
+			size_t totalCells	= 1;
+			for( int i = 0; i < kDimensions; i++ ) {
+				totalCells *= static_cast<size_t>( numCells[i] );
+			}
+			if( totalCells <= 2 * points->size() ) {
+				break;
+			}
+		}
+		VecT scale		= VecT( numCells ) / glm::max( size, VecT( cellSize ) );
+		
+		std::vector<uint32_t> ranks;
+		getCurveRanks( glm::max( toIVec3( numCells ), glm::ivec3( 1 ) ), order, &ranks );
+		
+		// counting sort of the points by the rank of their cell
+		std::vector<uint32_t> pointRanks( points->size() );
+		std::vector<uint32_t> offsets( ranks.size() + 1, 0 );
+		for( size_t i = 0; i < points->size(); i++ ) {
+			glm::ivec3 cell	= toIVec3( glm::min( IVecT( ( (*points)[i] - min ) * scale ), numCells - IVecT( 1 ) ) );
+			pointRanks[i]	= ranks[cell.x + ( cell.y + cell.z * static_cast<size_t>( numCells[1] ) ) * numCells[0]];
+			offsets[pointRanks[i] + 1]++;
+		}
+		for( size_t i = 1; i < offsets.size(); i++ ) {
+			offsets[i] += offsets[i - 1];
+		}
+		std::vector<VecT> sorted( points->size() );
+		for( size_t i = 0; i < points->size(); i++ ) {
+			sorted[offsets[pointRanks[i]]++] = (*points)[i];
+		}
+		points->swap( sorted );
+	}
+	
+	//! samples a single tile of the tiled algorithms inside \a grid, which has to cover the tile bounds inflated by twice the maximum separation. The points of the already sampled \a neighbors that fall in the grid seed the active list but are not added to \a output. Tiles that aren't reached by any point start from a random point.
+	template<typename GridT, typename VecT, typename URBG, typename DistFn, typename BoundsFn>
+	void sampleTile( GridT &grid, std::vector<int32_t> &processingList, URBG &rng, const DistFn &distFunction, float minSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &tileBounds, const std::vector<const std::vector<VecT>*> &neighbors, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options, SamplingBudget &budget, std::vector<VecT> *output )
+	{
+		POISSON_DISK_STAT( PoissonDiskStats stats; )
+		POISSON_DISK_STAT( double startTime = getTime(); )
+		output->reserve( output->size() + getMaxNumPoints( tileBounds, minSeparation ) );
+		
+		// add the points of the neighbors
+		for( const auto *neighbor : neighbors ) {
+			for( const auto &p : *neighbor ) {
+				if( grid.contains( p ) ) {
+					processingList.push_back( grid.add( p ) );
+				}
+			}
+		}
+		
+		// add the initial points
+		for( const auto &p : initialSet ) {
+			processingList.push_back( grid.add( p ) );
+			output->push_back( p );
+		}
+		budget.addPoints( initialSet.size() );
+		
+		// tiles that aren't reached by any point start from a random point
+		if( processingList.empty() && ! budget.isExhausted() ) {
+			VecT p = randPoint( rng, tileBounds );
+			if( boundsFunction( p ) && budget.addPoint() ) {
+				processingList.push_back( grid.add( p ) );
+				output->push_back( p );
+			}
+		}
+		
+		auto onAccepted = [&]( int32_t index ) {
+			output->push_back( grid.getPoint( index ) );
+		};
+		POISSON_DISK_STAT( stats.mSetupTime = getTime() - startTime; )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+		processActiveList( grid, processingList, rng, distFunction, boundsFunction, tileBounds, options, budget, onAccepted );
+		seedUnreachedRegions( grid, processingList, rng, distFunction, boundsFunction, tileBounds, options, budget, onAccepted );
+	}
+	
+	//! Tiled version of Bridson's algorithm. The bounds are split in tiles at least 2 * \a maxSeparation wide and tiles are sampled in 2^n phases, n being the number of dimensions, so that tiles of the same phase are never adjacent and can be sampled concurrently. Each tile only reads the output of the already processed neighboring tiles which seed its active list, and uses its own random stream so that the result doesn't depend on the number of threads. Tiles are passed to \a sink at the end of each phase, in which case an empty vector is returned. Each tile samples its own grid rather than a grid shared by all tiles, all points keep the separation of the serial algorithm but the result only matches it statistically.
+	template<typename VecT, typename URBG, typename DistFn, typename BoundsFn, typename SinkFn>
+	std::vector<VecT> tiledPoissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options, const SinkFn &sink )
+	{
+		const int dimensions	= GridTraits<VecT>::kDimensions;
+		const int numColors		= 1 << dimensions;
+		// the tile margins only hold for separations in the range, ie. when it was estimated by probing distFunction
+		auto clampedDistFunction = [&]( const VecT &p ) { return glm::clamp( distFunction( p ), minSeparation, maxSeparation ); };
+		
+		// tiles need to be wide enough for non-adjacent tiles to never see each other points
+		float cellSize		= getCellSize( minSeparation, maxSeparation, dimensions );
+		uint32_t capacity	= getCellCapacity( cellSize, minSeparation, dimensions );
+		float tileSize		= glm::max( options.getTileSize() > 0.0f ? options.getTileSize() : 64.0f * cellSize, 2.0f * maxSeparation );
+		VecT min			= getMin( bounds );
+		VecT size			= getMax( bounds ) - min;
+		glm::ivec3 numTiles	= glm::max( toIVec3( typename GridTraits<VecT>::IVecT( glm::ceil( size / tileSize ) ) ), glm::ivec3( 1 ) );
+		if( dimensions == 2 ) {
+			numTiles.z = 1;
+		}
+		size_t tileCount	= numTiles.x * numTiles.y * numTiles.z;
+		auto getTileCoords	= [&]( size_t i ) { return glm::ivec3( i % numTiles.x, ( i / numTiles.x ) % numTiles.y, i / ( numTiles.x * numTiles.y ) ); };
+		auto getTileIndex	= [&]( const glm::ivec3 &c ) { return static_cast<size_t>( c.x + numTiles.x * ( c.y + numTiles.y * c.z ) ); };
+		auto getTileColor	= [&]( const glm::ivec3 &c ) { return ( c.x & 1 ) | ( c.y & 1 ) << 1 | ( c.z & 1 ) << 2; };
+		auto getTileBounds	= [&]( const glm::ivec3 &c ) {
+			VecT tileMin = min + toVec( c, min ) * tileSize;
+			return makeBounds( tileMin, glm::min( tileMin + VecT( tileSize ), getMax( bounds ) ) );
+		};
+		
+		auto getGridBounds	= [&]( const glm::ivec3 &c ) {
+			auto tileBounds = getTileBounds( c );
+			return makeBounds( getMin( tileBounds ) - VecT( 2.0f * maxSeparation ), getMax( tileBounds ) + VecT( 2.0f * maxSeparation ) );
+		};
+		
+		// if there's no initial points start from the center point
+		std::vector<VecT> seeds = initialSet;
+		if( initialSet.empty() && isValidSeed( boundsFunction, bounds.getCenter() ) ) {
+			seeds.push_back( bounds.getCenter() );
+		}
+		
+		// distribute the initial points to their tiles. The tiles sampled before them, whose grid reaches them, get them as well so that their own points keep their distance to them
+		std::vector<std::vector<VecT>> tileOutputs( tileCount );
+		std::vector<std::vector<VecT>> tileInitialSets( tileCount );
+		std::vector<std::vector<VecT>> tileLaterSeeds( tileCount );
+		for( const auto &p : seeds ) {
+			glm::ivec3 c = glm::clamp( toIVec3( typename GridTraits<VecT>::IVecT( glm::floor( ( p - min ) / tileSize ) ) ), glm::ivec3( 0 ), numTiles - glm::ivec3( 1 ) );
+			tileInitialSets[getTileIndex( c )].push_back( p );
+			
+			// grids are inflated by less than a tile so only the adjacent tiles can reach the point
+			glm::ivec3 first	= glm::max( c - glm::ivec3( 1 ), glm::ivec3( 0 ) );
+			glm::ivec3 last		= glm::min( c + glm::ivec3( 1 ), numTiles - glm::ivec3( 1 ) );
+			for( int z = first.z; z <= last.z; z++ ) {
+				for( int y = first.y; y <= last.y; y++ ) {
+					for( int x = first.x; x <= last.x; x++ ) {
+						glm::ivec3 neighbor( x, y, z );
+						if( getTileColor( neighbor ) < getTileColor( c ) && contains( getGridBounds( neighbor ), p ) ) {
+							tileLaterSeeds[getTileIndex( neighbor )].push_back( p );
+						}
+					}
+				}
+			}
+		}
+		
+		POISSON_DISK_STAT( PoissonDiskStats stats; )
+		SamplingBudget budget( options );
+		uint32_t seed = getSeed( options );
+		for( int color = 0; color < numColors; color++ ) {
+			std::vector<size_t> tiles;
+			for( size_t i = 0; i < tileCount; i++ ) {
+				if( getTileColor( getTileCoords( i ) ) == color ) {
+					tiles.push_back( i );
+				}
+			}
+			
+			parallelFor( tiles.size(), [&]( size_t t ) {
+				size_t tileIndex		= tiles[t];
+				glm::ivec3 coords		= getTileCoords( tileIndex );
+				auto tileBounds			= getTileBounds( coords );
+				auto gridBounds			= getGridBounds( coords );
+				URBG rng( hashSeed( seed, static_cast<uint32_t>( tileIndex ) ) );
+				
+				// the points of the already processed neighbors and the initial points of the next ones seed the active list but are not part of this tile output
+				std::vector<const std::vector<VecT>*> neighbors( 1, &tileLaterSeeds[tileIndex] );
+				glm::ivec3 first	= glm::max( coords - glm::ivec3( 1 ), glm::ivec3( 0 ) );
+				glm::ivec3 last		= glm::min( coords + glm::ivec3( 1 ), numTiles - glm::ivec3( 1 ) );
+				for( int z = first.z; z <= last.z; z++ ) {
+					for( int y = first.y; y <= last.y; y++ ) {
+						for( int x = first.x; x <= last.x; x++ ) {
+							glm::ivec3 neighbor( x, y, z );
+							if( getTileColor( neighbor ) < color ) {
+								neighbors.push_back( &tileOutputs[getTileIndex( neighbor )] );
+							}
+						}
+					}
+				}
+				
+				std::vector<int32_t> processingList;
+				if( isMultiLevel( minSeparation, maxSeparation ) ) {
+					MultiLevelGrid<VecT> grid( gridBounds, minSeparation, maxSeparation );
+					sampleTile( grid, processingList, rng, clampedDistFunction, minSeparation, boundsFunction, tileBounds, neighbors, tileInitialSets[tileIndex], options, budget, &tileOutputs[tileIndex] );
+				}
+				else {
+					Grid<VecT> grid( gridBounds, cellSize, capacity );
+					sampleTile( grid, processingList, rng, clampedDistFunction, minSeparation, boundsFunction, tileBounds, neighbors, tileInitialSets[tileIndex], options, budget, &tileOutputs[tileIndex] );
+				}
+			}, options );
+			
+			// stream the tiles of this phase
+			POISSON_DISK_STAT( stats.mOutputTime -= getTime(); )
+			for( size_t tileIndex : tiles ) {
+				if( ! tileOutputs[tileIndex].empty() ) {
+					sink( tileOutputs[tileIndex].data(), tileOutputs[tileIndex].size() );
+				}
+			}
+			POISSON_DISK_STAT( stats.mOutputTime += getTime(); )
+		}
+		
+		if( ! std::is_same<SinkFn, NoSink>::value ) {
+			POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+			return std::vector<VecT>();
+		}
+		
+		// gather the tiles output
+		POISSON_DISK_STAT( stats.mOutputTime -= getTime(); )
+		size_t numPoints = 0;
+		for( const auto &tileOutput : tileOutputs ) {
+			numPoints += tileOutput.size();
+		}
+		std::vector<VecT> outputList;
+		outputList.reserve( numPoints );
+		for( const auto &tileOutput : tileOutputs ) {
+			outputList.insert( outputList.end(), tileOutput.begin(), tileOutput.end() );
+		}
+		POISSON_DISK_STAT( stats.mOutputTime += getTime(); )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+		return outputList;
+	}
+	
+	//! clears \a grid and \a processingList and adds the initial points, or the center of \a bounds when there's none, for the active list to be processed
+	template<typename GridT, typename VecT, typename BoundsFn>
+	void beginSampling( GridT &grid, std::vector<int32_t> &processingList, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, SamplingBudget &budget )
+	{
+		processingList.clear();
+		
+		// setup grid, reserving first so that the levels a multi-level grid adds are allocated once
+		grid.reserve( getMaxNumPoints( bounds, minSeparation ) );
+		setupGrid( grid, bounds, minSeparation, maxSeparation );
+		
+		// add the initial points
+		for( auto p : initialSet ){
+			processingList.push_back( grid.add( p ) );
+		}
+		
+		// if there's no initial points add the center point
+		if( !processingList.size() && isValidSeed( boundsFunction, bounds.getCenter() ) && budget.addPoint() ){
+			processingList.push_back( grid.add( bounds.getCenter() ) );
+		}
+		budget.addPoints( initialSet.size() );
+	}
+	
+	//! resumes processing the active list of \a grid until it's empty or the options budgets run out, returns whether the distribution is complete
+	template<typename GridT, typename URBG, typename DistFn, typename BoundsFn>
+	bool stepGrid( GridT &grid, std::vector<int32_t> &processingList, URBG &rng, const DistFn &distFunction, const BoundsFn &boundsFunction, const typename GridT::BoundsT &bounds, const PoissonDiskOptions &options )
+	{
+		SamplingBudget budget( options );
+		budget.addPoints( grid.getNumPoints() );
+		auto onAccepted = []( int32_t ) {};
+		processActiveList( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted );
+		seedUnreachedRegions( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted );
+		
+		// masks can still have unreached regions when the time ran out
+		bool isFull = options.getMaxPoints() && grid.getNumPoints() >= options.getMaxPoints();
+		return isFull || ( processingList.empty() && ! budget.isExhausted() );
+	}
+	
+	//! serial version of Bridson's algorithm, samples \a bounds inside \a grid using \a processingList as the active list. Both are cleared first and keep their memory so that they can be reused across calls.
+	template<typename URBG, typename GridT, typename VecT, typename DistFn, typename BoundsFn, typename SinkFn>
+	void sampleGrid( GridT &grid, std::vector<int32_t> &processingList, const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options, const SinkFn &sink )
+	{
+		POISSON_DISK_STAT( PoissonDiskStats stats; )
+		POISSON_DISK_STAT( double startTime = getTime(); )
+		
+		// prepare working structures, the time budget includes the setup
+		SamplingBudget budget( options );
+		URBG rng( getSeed( options ) );
+		beginSampling( grid, processingList, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, budget );
+		
+		// pass the points to the sink by chunks, directly from the grid storage
+		size_t numStreamed	= 0;
+		size_t chunkSize	= glm::max<size_t>( options.getChunkSize(), 1 );
+		auto onAccepted = [&]( int32_t ) {
+			if( grid.getNumPoints() - numStreamed >= chunkSize ) {
+				sink( grid.getPoints().data() + numStreamed, grid.getNumPoints() - numStreamed );
+				numStreamed = grid.getNumPoints();
+			}
+		};
+		
+		POISSON_DISK_STAT( stats.mSetupTime = getTime() - startTime; )
+		processActiveList( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted );
+		seedUnreachedRegions( grid, processingList, rng, distFunction, boundsFunction, bounds, options, budget, onAccepted );
+		POISSON_DISK_STAT( startTime = getTime(); )
+		
+		if( grid.getNumPoints() > numStreamed ) {
+			sink( grid.getPoints().data() + numStreamed, grid.getNumPoints() - numStreamed );
+		}
+		
+		POISSON_DISK_STAT( stats.mOutputTime = getTime() - startTime; )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+	}
+	
+	//! Parallel dart throwing over phase groups, after Wei's parallel Poisson disk sampling. Grid cells are small enough to hold a single point and are grouped in phases of cells far enough from each other to never see each other points, so every cell of a phase throws its dart independently. Each of the options k rounds throws one dart in every cell that can still receive a point, phase after phase, and cells entirely covered by the disk of a neighbor are retired. Random streams only depend on the seed, the round and the row of cells so the result doesn't depend on the number of threads.
+	template<typename VecT, typename URBG, typename DistFn, typename BoundsFn, typename SinkFn>
+	std::vector<VecT> dartThrowingPoissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options, const SinkFn &sink )
+	{
+		const int dimensions = GridTraits<VecT>::kDimensions;
+		enum : uint8_t { CELL_EMPTY, CELL_FULL, CELL_COVERED };
+		SamplingBudget budget( options );
+		
+		// cells have a diagonal of the minimum separation, and the cells of a phase are further apart than the maximum one
+		float cellSize		= glm::max( minSeparation / std::sqrt( (float) dimensions ), 1e-3f );
+		VecT min			= getMin( bounds );
+		VecT max			= getMax( bounds );
+		glm::ivec3 numCells	= glm::max( toIVec3( typename GridTraits<VecT>::IVecT( glm::ceil( ( max - min ) / cellSize ) ) ), glm::ivec3( 1 ) );
+		if( dimensions == 2 ) {
+			numCells.z = 1;
+		}
+		int window			= static_cast<int>( std::ceil( maxSeparation / cellSize ) );
+		int period			= window + 1;
+		glm::ivec3 periods	= glm::ivec3( period, period, dimensions == 3 ? period : 1 );
+		int numPhases		= periods.x * periods.y * periods.z;
+		size_t cellCount	= static_cast<size_t>( numCells.x ) * numCells.y * numCells.z;
+		std::vector<VecT> cellPoints( cellCount );
+		std::vector<uint8_t> cellStates( cellCount, CELL_EMPTY );
+		
+		// the initial points stay in their own grid tested by every dart
+		Grid<VecT> initialGrid;
+		if( ! initialSet.empty() ) {
+			float initialCellSize = getCellSize( minSeparation, maxSeparation, dimensions );
+			initialGrid.resize( bounds, initialCellSize, getCellCapacity( initialCellSize, minSeparation, dimensions ) );
+			for( const auto &p : initialSet ) {
+				initialGrid.add( p );
+			}
+		}
+		
+		POISSON_DISK_STAT( PoissonDiskStats timings; )
+		POISSON_DISK_STAT( double startTime = getTime(); )
+		budget.addPoints( initialSet.size() );
+		uint32_t seed = getSeed( options );
+		for( int round = 0; round < options.getK() && ! budget.isExhausted(); round++ ) {
+			std::atomic<size_t> numEmptyCells( 0 );
+			std::atomic<size_t> numDarts( 0 );
+			std::atomic<size_t> numAccepted( 0 );
+			for( int phase = 0; phase < numPhases && ! budget.isExhausted(); phase++ ) {
+				glm::ivec3 offset	= glm::ivec3( phase % periods.x, ( phase / periods.x ) % periods.y, phase / ( periods.x * periods.y ) );
+				glm::ivec3 numRows	= glm::max( ( numCells - offset + periods - glm::ivec3( 1 ) ) / periods, glm::ivec3( 0 ) );
+				
+				// each task processes the cells of the phase in a row
+				parallelFor( numRows.y * numRows.z, [&]( size_t row ) {
+					glm::ivec3 c( offset.x, offset.y + static_cast<int>( row % numRows.y ) * periods.y, offset.z + static_cast<int>( row / numRows.y ) * periods.z );
+					URBG rng( hashSeed( hashSeed( seed, static_cast<uint32_t>( round * numPhases + phase ) ), static_cast<uint32_t>( c.y + c.z * numCells.y ) ) );
+					size_t numEmpty		= 0;
+					size_t numRowDarts	= 0;
+					size_t numRowAccepted = 0;
+					POISSON_DISK_STAT( PoissonDiskStats stats; )
+					for( ; c.x < numCells.x && ! budget.isExhausted(); c.x += periods.x ) {
+						size_t j = c.x + numCells.x * ( c.y + static_cast<size_t>( numCells.y ) * c.z );
+						if( cellStates[j] != CELL_EMPTY ) {
+							continue;
+						}
+						
+						VecT cellMin	= min + toVec( c, min ) * cellSize;
+						VecT cellMax	= glm::min( cellMin + VecT( cellSize ), max );
+						VecT p			= randPoint( rng, makeBounds( cellMin, cellMax ) );
+						numRowDarts++;
+						POISSON_DISK_STAT( stats.mNumCandidates++; )
+						if( ! boundsFunction( p ) ) {
+							POISSON_DISK_STAT( stats.mNumRejectedByBoundsFunction++; )
+							numEmpty++;
+							continue;
+						}
+						
+						// test the points of the cells within the separation, the phases only hold for separations in the range
+						float dist		= glm::clamp( distFunction( p ), minSeparation, maxSeparation );
+						int reach		= glm::min( static_cast<int>( std::ceil( dist / cellSize ) ), window );
+						glm::ivec3 minCell = glm::max( c - glm::ivec3( reach ), glm::ivec3( 0 ) );
+						glm::ivec3 maxCell = glm::min( c + glm::ivec3( reach + 1 ), numCells );
+						if( dimensions == 2 ) {
+							minCell.z = 0;
+							maxCell.z = 1;
+						}
+						bool isValid	= true;
+						bool isCovered	= false;
+						for( int z = minCell.z; isValid && z < maxCell.z; z++ ) {
+							for( int y = minCell.y; isValid && y < maxCell.y; y++ ) {
+								for( int x = minCell.x; isValid && x < maxCell.x; x++ ) {
+									size_t k = x + numCells.x * ( y + static_cast<size_t>( numCells.y ) * z );
+									POISSON_DISK_STAT( stats.mNumCellsVisited++; )
+									POISSON_DISK_STAT( stats.mNumPointsCompared += cellStates[k] == CELL_FULL; )
+									if( cellStates[k] == CELL_FULL && glm::length2( p - cellPoints[k] ) < dist * dist ) {
+										// the cell is covered when its furthest corner is closer than the minimum separation
+										const VecT &q	= cellPoints[k];
+										isValid			= false;
+										isCovered		= glm::length2( glm::max( glm::abs( q - cellMin ), glm::abs( q - cellMax ) ) ) < minSeparation * minSeparation;
+									}
+								}
+							}
+						}
+						if( isValid && initialGrid.getNumPoints() ) {
+							isValid = ! initialGrid.hasNeighbors( p, dist );
+						}
+						
+						POISSON_DISK_STAT( stats.mNumNeighborQueries++; )
+						if( isValid && ! budget.addPoint() ) {
+							break;
+						}
+						if( isValid ) {
+							cellPoints[j] = p;
+							cellStates[j] = CELL_FULL;
+							numRowAccepted++;
+							POISSON_DISK_STAT( stats.mNumAccepted++; )
+						}
+						else {
+							POISSON_DISK_STAT( stats.mNumRejectedByNeighbors++; )
+							if( isCovered ) {
+								cellStates[j] = CELL_COVERED;
+							}
+							else {
+								numEmpty++;
+							}
+						}
+					}
+					numEmptyCells	+= numEmpty;
+					numDarts		+= numRowDarts;
+					numAccepted		+= numRowAccepted;
+					POISSON_DISK_STAT( mergeStats( options.getStats(), stats ); )
+				}, options );
+			}
+			if( ! numEmptyCells || numAccepted < options.getMinAcceptanceRate() * numDarts ) {
+				break;
+			}
+		}
+		
+		POISSON_DISK_STAT( timings.mSamplingTime = getTime() - startTime; )
+		POISSON_DISK_STAT( startTime = getTime(); )
+		
+		// gather the points in cell order after the initial ones
+		std::vector<VecT> points( initialSet );
+		for( size_t j = 0; j < cellCount; j++ ) {
+			if( cellStates[j] == CELL_FULL ) {
+				points.push_back( cellPoints[j] );
+			}
+		}
+		
+		if( ! std::is_same<SinkFn, NoSink>::value ) {
+			size_t chunkSize = glm::max<size_t>( options.getChunkSize(), 1 );
+			for( size_t i = 0; i < points.size(); i += chunkSize ) {
+				sink( points.data() + i, glm::min( chunkSize, points.size() - i ) );
+			}
+			points.clear();
+		}
+		POISSON_DISK_STAT( timings.mOutputTime = getTime() - startTime; )
+		POISSON_DISK_STAT( mergeStats( options.getStats(), timings ); )
+		return points;
+	}
+	
+	//! Bridson's algorithm shared by all distributions. \a distFunction returns the separation around each point, in the [ \a minSeparation, \a maxSeparation ] range, and \a boundsFunction whether a candidate is valid. Both are template policies so that constant separations and lambdas don't go through an indirect call. The grid is the only storage of the points, they are either returned or passed to \a sink in chunks as they're accepted.
+	template<typename VecT, typename URBG, typename DistFn, typename BoundsFn, typename SinkFn = NoSink>
+	std::vector<VecT> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const typename GridTraits<VecT>::BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options, const SinkFn &sink = SinkFn() )
+	{
+		if( options.getOrder() != PoissonDiskOptions::ACCEPTANCE_ORDER ) {
+			// sorting needs all the points, the sink gets them in chunks afterwards
+			std::vector<VecT> points = poissonDiskDistribution<VecT, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, PoissonDiskOptions( options ).order( PoissonDiskOptions::ACCEPTANCE_ORDER ) );
+			POISSON_DISK_STAT( PoissonDiskStats timings; )
+			POISSON_DISK_STAT( double startTime = getTime(); )
+			sortAlongCurve( &points, options.getOrder() );
+			if( ! std::is_same<SinkFn, NoSink>::value ) {
+				size_t chunkSize = glm::max<size_t>( options.getChunkSize(), 1 );
+				for( size_t i = 0; i < points.size(); i += chunkSize ) {
+					sink( points.data() + i, glm::min( chunkSize, points.size() - i ) );
+				}
+			}
+			POISSON_DISK_STAT( timings.mOutputTime = getTime() - startTime; )
+			POISSON_DISK_STAT( mergeStats( options.getStats(), timings ); )
+			if( ! std::is_same<SinkFn, NoSink>::value ) {
+				return std::vector<VecT>();
+			}
+			return points;
+		}
+		if( options.getEngine() == PoissonDiskOptions::DART_THROWING ) {
+			return dartThrowingPoissonDiskDistribution<VecT, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, sink );
+		}
+		if( options.isTiled() ) {
+			return tiledPoissonDiskDistribution<VecT, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, sink );
+		}
+		
+		std::vector<int32_t> processingList;
+		std::vector<VecT> points;
+		if( isMultiLevel( minSeparation, maxSeparation ) ) {
+			MultiLevelGrid<VecT> grid;
+			sampleGrid<URBG>( grid, processingList, distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, sink );
+			points = grid.releasePoints();
+		}
+		else {
+			Grid<VecT> grid;
+			sampleGrid<URBG>( grid, processingList, distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, sink );
+			points = grid.releasePoints();
+		}
+		
+		if( ! std::is_same<SinkFn, NoSink>::value ) {
+			return std::vector<VecT>();
+		}
+		return points;
+	}
+} // namespace poisson_detail
+
+// Reusable Poisson Disk Distribution
+
+//! Sampler owning the acceleration grid and work buffers of the distribution so that they can be reused by consecutive calls. Once the buffers have grown to the largest distribution sampled, new samples with different bounds, separations or seeds don't allocate. Sampling is always serial and ignores the options threads and executor, use one sampler per thread to sample several distributions in parallel. DART_THROWING runs the dart throwing engine, which keeps its own buffers and allocates on every call, and can't be resumed: the first step() samples the whole distribution. Sorted orders are applied to a copy of the points once the distribution is complete.
+template<typename VecT, typename URBG = PoissonDiskRandom>
+class PoissonDiskSamplerT {
+public:
+	using BoundsT = typename poisson_detail::GridTraits<VecT>::BoundsT;
+	
+	PoissonDiskSamplerT() : mIsMultiLevel( false ), mHasOutput( false ), mOrder( PoissonDiskOptions::ACCEPTANCE_ORDER ) {}
+	
+	//! samples a poisson disk distribution with a minimum \a separation inside \a bounds. The returned points are owned by the sampler and valid until the next call.
+	const std::vector<VecT>& sample( float separation, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! samples a poisson disk distribution inside \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. The returned points are owned by the sampler and valid until the next call.
+	template<typename DistFn>
+	const std::vector<VecT>& sample( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! samples a poisson disk distribution within bounds defined by both \a boundsFunction and \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. The returned points are owned by the sampler and valid until the next call.
+	template<typename DistFn, typename BoundsFn>
+	const std::vector<VecT>& sample( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	
+	//! starts sampling a poisson disk distribution with a minimum \a separation inside \a bounds, the active list being processed by the following calls to step(). Replaces the points of the last sample.
+	void begin( float separation, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! starts sampling a poisson disk distribution inside \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. \a distFunction is copied and used by the following calls to step().
+	template<typename DistFn>
+	void begin( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! starts sampling a poisson disk distribution within bounds defined by both \a boundsFunction and \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. Both functions are copied and used by the following calls to step().
+	template<typename DistFn, typename BoundsFn>
+	void begin( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const BoundsT &bounds, const std::vector<VecT> &initialSet = std::vector<VecT>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! processes the active list of the distribution started by begin() for about \a seconds and returns the points accepted so far, in acceptance order until the distribution is complete. The grid, active list and random engine are kept between calls so that sampling resumes where it stopped, the complete distribution being the same as the one sample() returns with the same options unless they use adaptive k or an acceptance rate, whose measures restart with each step. The options time budget is replaced by \a seconds, 0 completing the distribution.
+	const std::vector<VecT>& step( double seconds );
+	//! returns whether the distribution started by begin() is complete, or whether there's no distribution in progress
+	bool isComplete() const { return ! mStep; }
+	
+	//! returns the points of the last sample
+	const std::vector<VecT>& getPoints() const { return mHasOutput ? mOutput : mIsMultiLevel ? mMultiLevelGrid.getPoints() : mGrid.getPoints(); }
+	//! reserves memory for \a numPoints points, ie. to avoid the first calls growing the buffers. Covers both the grid of narrow and wide ranges of separations.
+	void reserve( size_t numPoints ) { mGrid.reserve( numPoints ); mMultiLevelGrid.reserve( numPoints ); mProcessingList.reserve( numPoints ); }
+	//! removes the points of the last sample while keeping the memory of the sampler
+	void clear() { mGrid.clear(); mMultiLevelGrid.clear(); mProcessingList.clear(); mOutput.clear(); mHasOutput = false; mStep = nullptr; }
+	
+protected:
+	//! sorts the points of the completed distribution along mOrder, in mOutput
+	void sortOutput();
+	
+	poisson_detail::Grid<VecT>				mGrid;
+	poisson_detail::MultiLevelGrid<VecT>	mMultiLevelGrid; // used for wide ranges of separations
+	bool									mIsMultiLevel;
+	std::vector<VecT>						mOutput; // points of the distributions that aren't stored in the grids, or sorted points
+	bool									mHasOutput;
+	PoissonDiskOptions::Order				mOrder;
+	std::vector<int32_t>					mProcessingList;
+	URBG									mRng;
+	std::function<bool( PoissonDiskSamplerT&, double )> mStep; // processes the distribution in progress for a number of seconds, returns whether it's complete
+};
+
+typedef PoissonDiskSamplerT<glm::vec2>	PoissonDiskSampler;
+typedef PoissonDiskSamplerT<glm::vec3>	PoissonDiskSampler3d;
+
+// Indexed Poisson Disk Distribution
+
+//! Read-only spatial index over a set of points, backed by the acceleration grid of the sampling functions. The poissonDiskDistributionIndex functions keep the grid the points were sampled with instead of building another structure over the result.
+template<typename VecT>
+class PoissonDiskIndexT {
+public:
+	using BoundsT = typename poisson_detail::GridTraits<VecT>::BoundsT;
+	
+	PoissonDiskIndexT() {}
+	//! indexes \a points in cells that hold a single point when the points are at least \a separation apart
+	PoissonDiskIndexT( const std::vector<VecT> &points, float separation );
+	//! takes over a \a grid filled by the sampling functions
+	explicit PoissonDiskIndexT( poisson_detail::Grid<VecT> &&grid );
+	
+	//! appends to \a indices the points closer than \a radius to \a p
+	void getPointsInRadius( const VecT &p, float radius, std::vector<int32_t> *indices ) const;
+	//! appends to \a indices the points inside \a bounds, upper corner included
+	void getPointsInBounds( const BoundsT &bounds, std::vector<int32_t> *indices ) const;
+	//! returns the index of the point nearest to \a p, or -1 if there's no point closer than \a maxDistance
+	int32_t getNearest( const VecT &p, float maxDistance = std::numeric_limits<float>::max() ) const;
+	
+	//! returns the point at \a index
+	const VecT& getPoint( int32_t index ) const { return mGrid.getPoint( index ); }
+	//! returns the indexed points, in the order they were sampled or passed
+	const std::vector<VecT>& getPoints() const { return mGrid.getPoints(); }
+	//! returns the number of points
+	size_t size() const { return mGrid.getNumPoints(); }
+	//! returns whether the index is empty
+	bool empty() const { return mGrid.getNumPoints() == 0; }
+	
+protected:
+	//! lists the points outside of the grid bounds, which its cells don't hold
+	void findOutsidePoints();
+	
+	poisson_detail::Grid<VecT>	mGrid;
+	std::vector<int32_t>		mOutside;
+};
+
+typedef PoissonDiskIndexT<glm::vec2>	PoissonDiskIndex;
+typedef PoissonDiskIndexT<glm::vec3>	PoissonDiskIndex3d;
+
+//! returns an index of poisson disk samples inside a rectangular \a area, with a minimum \a separation
+PoissonDiskIndex poissonDiskDistributionIndex( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns an index of poisson disk samples inside a rectangular \a area, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range. Wide ranges of separations, tiled sampling, DART_THROWING and sorted orders build the index over the result.
+PoissonDiskIndex poissonDiskDistributionIndex( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns an index of poisson disk samples within bounds defined by both \a boundsFunction and a rectangular \a area, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range
+PoissonDiskIndex poissonDiskDistributionIndex( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns an index of poisson disk samples within cubic \a bounds, with a minimum \a separation
+PoissonDiskIndex3d poissonDiskDistributionIndex( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns an index of poisson disk samples within cubic \a bounds, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range
+PoissonDiskIndex3d poissonDiskDistributionIndex( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns an index of poisson disk samples within bounds defined by both \a boundsFunction and cubic \a bounds, with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range
+PoissonDiskIndex3d poissonDiskDistributionIndex( const std::function<float(const glm::vec3&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec3&)> &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet = std::vector<glm::vec3>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// Editable Poisson Disk Distribution
+
+//! 2D distribution that can be edited region by region. Erased regions are refilled from the points surrounding them instead of resampling the whole bounds, so the cost of an edit scales with the edited area. Removing points moves the last points of the distribution to the freed indices.
+class PoissonDiskEditor {
+public:
+	//! samples \a bounds with a minimum \a separation
+	PoissonDiskEditor( float separation, const ci::Rectf &bounds, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! samples \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range
+	PoissonDiskEditor( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &bounds, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! samples the bounds defined by both \a boundsFunction and \a bounds with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range
+	PoissonDiskEditor( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &bounds, const PoissonDiskOptions &options = PoissonDiskOptions() );
+	
+	//! removes the points inside \a region and returns their number
+	size_t erase( const ci::Rectf &region );
+	//! removes the points inside the circle of \a radius around \a center and returns their number
+	size_t erase( const glm::vec2 &center, float radius );
+	//! samples the empty space of \a region, the active list being seeded with the points around and inside it. Returns the number of added points.
+	size_t fill( const ci::Rectf &region );
+	//! erases and refills \a region, returns the number of added points
+	size_t resample( const ci::Rectf &region );
+	//! erases and refills the circle of \a radius around \a center, returns the number of added points
+	size_t resample( const glm::vec2 &center, float radius );
+	
+	//! sets the function used by the next fills to compute the separation, in the [ \a minSeparation, \a maxSeparation ] range. The grid is rebuilt if the range changes.
+	void setDistFunction( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation );
+	//! sets the function used by the next fills to reject points
+	void setBoundsFunction( const std::function<bool(const glm::vec2&)> &boundsFunction ) { mBoundsFunction = boundsFunction; }
+	
+	//! returns the points of the distribution
+	const std::vector<glm::vec2>& getPoints() const { return mGrid.getPoints(); }
+	//! returns the number of points of the distribution
+	size_t	getNumPoints() const { return mGrid.getNumPoints(); }
+	//! returns the bounds of the distribution
+	const ci::Rectf& getBounds() const { return mBounds; }
+	
+protected:
+	template<typename RegionFn>
+	size_t eraseIf( const ci::Rectf &region, const RegionFn &contains );
+	
+	poisson_detail::Grid<glm::vec2>			mGrid;
+	std::vector<int32_t>					mProcessingList;
+	std::vector<int32_t>					mIndices;
+	std::function<float(const glm::vec2&)>	mDistFunction;
+	std::function<bool(const glm::vec2&)>	mBoundsFunction;
+	float					mMinSeparation, mMaxSeparation;
+	ci::Rectf				mBounds;
+	PoissonDiskOptions		mOptions;
+	PoissonDiskRandom		mRng;
+};
+
+// Quantized Poisson Disk Distribution
+
+//! 2D points stored with fewer bits within known bounds, for memory and for GPU upload as instance buffers. UNORM16 and FLOAT16 coordinates can be uploaded as is, ie. as normalized unsigned shorts or half floats attributes, and dequantized with getScale() and getOffset(). CELL_OFFSET stores which cells of a grid as fine as the minimum separation allows hold a point, and the position of the point inside its cell, and has to be decoded on the CPU.
+class PoissonDiskQuantizedPoints {
+public:
+	//! Storage of the coordinates
+	enum Format {
+		//! 4 bytes per point, 16-bit fixed point coordinates relative to the bounds, precise to 1/131070th of the bounds size
+		UNORM16,
+		//! 4 bytes per point, precise to about 1/2000th of the coordinates magnitude
+		FLOAT16,
+		//! about 2.5 bytes per point for a tightly packed distribution, 8-bit offsets in cells of minimum separation / sqrt( 2 ) holding a single point, precise to 1/724th of the separation. Points are kept in the row order of the cells. The bounds are split in at most 4096 x 4096 cells, points sharing a cell with another one being stored as floats after the others.
+		CELL_OFFSET
+	};
+	
+	PoissonDiskQuantizedPoints() : PoissonDiskQuantizedPoints( UNORM16, ci::Rectf( 0.0f, 0.0f, 0.0f, 0.0f ), 0.0f ) {}
+	//! creates an empty set of points stored in \a format inside \a bounds, \a separation being the minimum separation of the points used by CELL_OFFSET
+	PoissonDiskQuantizedPoints( Format format, const ci::Rectf &bounds, float separation );
+	//! quantizes the \a count \a points inside \a bounds, \a separation being their minimum separation
+	PoissonDiskQuantizedPoints( Format format, const glm::vec2 *points, size_t count, const ci::Rectf &bounds, float separation );
+	
+	//! quantizes and adds \a count \a points, ie. from the sink of the streaming functions. Points closer than the separation are kept as floats with CELL_OFFSET. finish() has to be called before reading CELL_OFFSET points, appending after finish() moves the CELL_OFFSET cells back to their uncompacted storage so that finish() has to be called again.
+	void append( const glm::vec2 *points, size_t count );
+	//! compacts the CELL_OFFSET cells once all the points are added
+	void finish();
+	
+	//! returns the number of points
+	size_t	size() const { return mNumPoints; }
+	//! returns whether there's no points
+	bool	empty() const { return ! mNumPoints; }
+	//! returns the storage of the coordinates
+	Format	getFormat() const { return mFormat; }
+	//! returns the bounds the points are quantized in
+	const ci::Rectf& getBounds() const { return mBounds; }
+	//! returns the UNORM16 or FLOAT16 coordinates, two components per point, nullptr with CELL_OFFSET
+	const uint16_t* getData() const { return mFormat != CELL_OFFSET ? mCoords.data() : nullptr; }
+	//! returns the number of bytes used by the points
+	size_t	getDataSize() const;
+	//! returns the factor applied to the normalized UNORM16 coordinates, or to the FLOAT16 ones, before adding getOffset()
+	glm::vec2 getScale() const { return mFormat == UNORM16 ? mBounds.getSize() : glm::vec2( 1.0f ); }
+	//! returns the offset added to the scaled UNORM16 or FLOAT16 coordinates
+	glm::vec2 getOffset() const { return mFormat == UNORM16 ? mBounds.getUpperLeft() : glm::vec2( 0.0f ); }
+	
+	//! returns the point \a index decoded from the storage format. CELL_OFFSET points are found with a binary search over the cells.
+	glm::vec2 getPoint( size_t index ) const
+	{
+		if( mFormat == UNORM16 ) {
+			return poisson_detail::fromUnorm16( mCoords.data() + 2 * index, mBounds );
+		}
+		else if( mFormat == FLOAT16 ) {
+			return glm::vec2( poisson_detail::halfToFloat( mCoords[2 * index] ), poisson_detail::halfToFloat( mCoords[2 * index + 1] ) );
+		}
+		return getCellPoint( index );
+	}
+	//! returns the decoded points
+	std::vector<glm::vec2> decode() const;
+	//! appends the decoded points to \a output
+	void decode( std::vector<glm::vec2> *output ) const;
+	
+protected:
+	glm::vec2 getCellPoint( size_t index ) const;
+	glm::vec2 getCellPoint( size_t cell, uint16_t offset ) const;
+	//! moves the offsets compacted by finish() back to one per cell
+	void expand();
+	
+	Format					mFormat;
+	ci::Rectf				mBounds;
+	size_t					mNumPoints;
+	std::vector<uint16_t>	mCoords; // UNORM16 and FLOAT16 coordinates
+	
+	// CELL_OFFSET storage
+	float					mCellSize;
+	glm::ivec2				mNumCells;
+	std::vector<uint64_t>	mOccupancy; // one bit per cell holding a point
+	std::vector<uint32_t>	mRanks; // number of points before each word of mOccupancy
+	std::vector<uint16_t>	mOffsets; // 8-bit x and y offsets of the points inside their cells, per cell until finish() and per point after
+	std::vector<glm::vec2>	mOverflow; // points sharing a cell with another one, after the cell points
+};
+
+//! returns the poisson disk samples inside \a area with a minimum \a separation, quantized to \a format as they're sampled so that the full precision points are never stored.
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns the poisson disk samples inside \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, quantized to \a format as they're sampled.
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+//! returns the poisson disk samples within bounds defined by both \a boundsFunction and \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, quantized to \a format as they're sampled.
+PoissonDiskQuantizedPoints poissonDiskDistributionQuantized( PoissonDiskQuantizedPoints::Format format, const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+
+// Cached Poisson Disk Distribution
+
+//! 2D points read from a PoissonDiskCache file. Points found in the cache are a memory-mapped view of the file, freshly sampled ones own their memory. Coordinates are either floats read in place, or half floats or 16-bit fixed point coordinates relative to the bounds, decoded on access. Movable but not copyable.
+class PoissonDiskCachedPoints {
+public:
+	//! Storage of the coordinates
+	enum Format {
+		//! 8 bytes per point, exact
+		FLOAT32,
+		//! 4 bytes per point, precise to about 1/2000th of the coordinates magnitude
+		FLOAT16,
+		//! 4 bytes per point, precise to 1/131070th of the bounds size
+		UNORM16
+	};
+	
+	PoissonDiskCachedPoints();
+	PoissonDiskCachedPoints( PoissonDiskCachedPoints &&other );
+	PoissonDiskCachedPoints& operator=( PoissonDiskCachedPoints &&other );
+	PoissonDiskCachedPoints( const PoissonDiskCachedPoints & ) = delete;
+	PoissonDiskCachedPoints& operator=( const PoissonDiskCachedPoints & ) = delete;
+	~PoissonDiskCachedPoints();
+	
+	//! returns the number of points
+	size_t	size() const { return mNumPoints; }
+	//! returns whether there's no points
+	bool	empty() const { return ! mNumPoints; }
+	//! returns the storage of the coordinates
+	Format	getFormat() const { return mFormat; }
+	//! returns the bounds the distribution was sampled in, which UNORM16 coordinates are relative to
+	const ci::Rectf& getBounds() const { return mBounds; }
+	//! returns whether the points are a memory-mapped view of the cache file
+	bool	isMapped() const { return mMapping != nullptr; }
+	//! returns the raw coordinates, two components per point in the storage format, ie. to upload them
+	const void* getData() const { return mData; }
+	//! returns the points when stored as FLOAT32, nullptr otherwise
+	const glm::vec2* getPoints() const { return mFormat == FLOAT32 ? reinterpret_cast<const glm::vec2*>( mData ) : nullptr; }
+	//! returns the point \a index decoded from the storage format
+	glm::vec2 getPoint( size_t index ) const
+	{
+		if( mFormat == FLOAT32 ) {
+			return reinterpret_cast<const glm::vec2*>( mData )[index];
+		}
+		const uint16_t *c = reinterpret_cast<const uint16_t*>( mData ) + 2 * index;
+		if( mFormat == FLOAT16 ) {
+			return glm::vec2( poisson_detail::halfToFloat( c[0] ), poisson_detail::halfToFloat( c[1] ) );
+		}
+		return poisson_detail::fromUnorm16( c, mBounds );
+	}
+	//! returns the decoded points
+	std::vector<glm::vec2> decode() const;
+	
+protected:
+	friend class PoissonDiskCache;
+	
+	const uint8_t			*mData;
+	size_t					mNumPoints;
+	Format					mFormat;
+	ci::Rectf				mBounds;
+	void					*mMapping; // view of the file, unmapped on destruction
+	size_t					mMappingSize;
+	std::vector<uint8_t>	mBuffer; // encoded points when they're not mapped
+};
+
+//! Cache of 2D distributions stored as binary files in a directory, one file per set of parameters. Files are named after a hash of the bounds, separations, initial points and options that affect the result, and of a version tag standing for the distance and bounds functions, which the cache can't hash. Bump the version whenever the functions change. Distributions are only cached when the options have a seed, no time budget and no point budget with tiled sampling or DART_THROWING, the other ones being sampled on every call.
+class PoissonDiskCache {
+public:
+	//! creates a cache storing its files in \a directory, which has to exist, with the coordinates stored in \a format
+	explicit PoissonDiskCache( const std::string &directory, PoissonDiskCachedPoints::Format format = PoissonDiskCachedPoints::FLOAT32 );
+	
+	//! returns the poisson disk samples inside \a area with a minimum \a separation, mapped from the cache or sampled and written to it
+	PoissonDiskCachedPoints get( float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! returns the poisson disk samples inside \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, mapped from the cache or sampled and written to it. \a version identifies \a distFunction.
+	PoissonDiskCachedPoints get( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, uint32_t version, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	//! returns the poisson disk samples within bounds defined by both \a boundsFunction and \a area with a minimum separation defined by what \a distFunction returns in the [ \a minSeparation, \a maxSeparation ] range, mapped from the cache or sampled and written to it. \a version identifies both functions.
+	PoissonDiskCachedPoints get( const std::function<float(const glm::vec2&)> &distFunction, float minSeparation, float maxSeparation, const std::function<bool(const glm::vec2&)> &boundsFunction, uint32_t version, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet = std::vector<glm::vec2>(), const PoissonDiskOptions &options = PoissonDiskOptions() );
+	
+	//! returns the directory of the cache files
+	const std::string& getDirectory() const { return mDirectory; }
+	//! returns the storage of the coordinates of the new files
+	PoissonDiskCachedPoints::Format getFormat() const { return mFormat; }
+	
+protected:
+	//! maps the file of the parameters, or calls \a sample and writes its points to a new file. \a functionsVersion combines the version tag and which functions are used.
+	PoissonDiskCachedPoints getOrSample( const std::function<std::vector<glm::vec2>()> &sample, float minSeparation, float maxSeparation, uint64_t functionsVersion, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options );
+	
+	std::string						mDirectory;
+	PoissonDiskCachedPoints::Format	mFormat;
+};
+
+template<typename URBG>
+std::vector<glm::vec2> poissonDiskDistribution( float separation, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename URBG, typename DistFn>
+std::vector<glm::vec2> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename URBG, typename DistFn, typename BoundsFn>
+std::vector<glm::vec2> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::Rectf &bounds, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options );
+}
+
+template<typename URBG>
+std::vector<glm::vec3> poissonDiskDistribution( float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename URBG, typename DistFn>
+std::vector<glm::vec3> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename URBG, typename DistFn, typename BoundsFn>
+std::vector<glm::vec3> poissonDiskDistribution( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	return poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options );
+}
+
+template<typename URBG, typename SinkFn>
+void poissonDiskDistributionStream( const SinkFn &sink, float separation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), area, initialSet, options, sink );
+}
+
+template<typename URBG, typename SinkFn, typename DistFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), area, initialSet, options, sink );
+}
+
+template<typename URBG, typename SinkFn, typename DistFn, typename BoundsFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::Rectf &area, const std::vector<glm::vec2> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec2, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, area, initialSet, options, sink );
+}
+
+template<typename URBG, typename SinkFn>
+void poissonDiskDistributionStream( const SinkFn &sink, float separation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options, sink );
+}
+
+template<typename URBG, typename SinkFn, typename DistFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options, sink );
+}
+
+template<typename URBG, typename SinkFn, typename DistFn, typename BoundsFn>
+void poissonDiskDistributionStream( const SinkFn &sink, const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const ci::AxisAlignedBox &bounds, const std::vector<glm::vec3> &initialSet, const PoissonDiskOptions &options )
+{
+	poisson_detail::poissonDiskDistribution<glm::vec3, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, sink );
+}
+
+template<typename VecT, typename URBG>
+const std::vector<VecT>& PoissonDiskSamplerT<VecT, URBG>::sample( float separation, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	return sample( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename VecT, typename URBG>
+template<typename DistFn>
+const std::vector<VecT>& PoissonDiskSamplerT<VecT, URBG>::sample( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	return sample( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename VecT, typename URBG>
+template<typename DistFn, typename BoundsFn>
+const std::vector<VecT>& PoissonDiskSamplerT<VecT, URBG>::sample( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	mStep			= nullptr;
+	mHasOutput		= false;
+	mOrder			= options.getOrder();
+	mIsMultiLevel	= poisson_detail::isMultiLevel( minSeparation, maxSeparation );
+	if( options.getEngine() == PoissonDiskOptions::DART_THROWING ) {
+		mOutput		= poisson_detail::dartThrowingPoissonDiskDistribution<VecT, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, poisson_detail::getSerialOptions( options ), poisson_detail::NoSink() );
+		mHasOutput	= true;
+	}
+	else if( mIsMultiLevel ) {
+		poisson_detail::sampleGrid<URBG>( mMultiLevelGrid, mProcessingList, distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, poisson_detail::NoSink() );
+	}
+	else {
+		poisson_detail::sampleGrid<URBG>( mGrid, mProcessingList, distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, options, poisson_detail::NoSink() );
+	}
+	sortOutput();
+	return getPoints();
+}
+
+template<typename VecT, typename URBG>
+void PoissonDiskSamplerT<VecT, URBG>::begin( float separation, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	begin( poisson_detail::ConstantSeparation{ separation }, separation, separation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename VecT, typename URBG>
+template<typename DistFn>
+void PoissonDiskSamplerT<VecT, URBG>::begin( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	begin( distFunction, minSeparation, maxSeparation, poisson_detail::NoBoundsFunction(), bounds, initialSet, options );
+}
+
+template<typename VecT, typename URBG>
+template<typename DistFn, typename BoundsFn>
+void PoissonDiskSamplerT<VecT, URBG>::begin( const DistFn &distFunction, float minSeparation, float maxSeparation, const BoundsFn &boundsFunction, const BoundsT &bounds, const std::vector<VecT> &initialSet, const PoissonDiskOptions &options )
+{
+	using namespace poisson_detail;
+	
+	// dart throwing can't be resumed, the first step samples the whole distribution
+	mHasOutput	= false;
+	mOrder		= options.getOrder();
+	if( options.getEngine() == PoissonDiskOptions::DART_THROWING ) {
+		mOutput.clear();
+		mHasOutput = true;
+		std::vector<VecT> initialPoints = initialSet;
+		PoissonDiskOptions dartOptions = getSerialOptions( options );
+		mStep = [distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialPoints, dartOptions]( PoissonDiskSamplerT &sampler, double ) {
+			sampler.mOutput = dartThrowingPoissonDiskDistribution<VecT, URBG>( distFunction, minSeparation, maxSeparation, boundsFunction, bounds, initialPoints, dartOptions, NoSink() );
+			return true;
+		};
+		return;
+	}
+	
+	// the initial points always go in the distribution, only the point limit of the options carries to the steps
+	SamplingBudget budget( PoissonDiskOptions().maxPoints( options.getMaxPoints() ) );
+	mRng			= URBG( getSeed( options ) );
+	mIsMultiLevel	= isMultiLevel( minSeparation, maxSeparation );
+	if( mIsMultiLevel ) {
+		beginSampling( mMultiLevelGrid, mProcessingList, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, budget );
+	}
+	else {
+		beginSampling( mGrid, mProcessingList, minSeparation, maxSeparation, boundsFunction, bounds, initialSet, budget );
+	}
+	
+	// the step keeps copies of the functions and options, the grid and active list are those of the sampler it's called with
+	PoissonDiskOptions stepOptions = options;
+	mStep = [distFunction, boundsFunction, bounds, stepOptions]( PoissonDiskSamplerT &sampler, double seconds ) {
+		PoissonDiskOptions options = stepOptions;
+		options.timeBudget( seconds );
+		if( sampler.mIsMultiLevel ) {
+			return stepGrid( sampler.mMultiLevelGrid, sampler.mProcessingList, sampler.mRng, distFunction, boundsFunction, bounds, options );
+		}
+		return stepGrid( sampler.mGrid, sampler.mProcessingList, sampler.mRng, distFunction, boundsFunction, bounds, options );
+	};
+}
+
+template<typename VecT, typename URBG>
+const std::vector<VecT>& PoissonDiskSamplerT<VecT, URBG>::step( double seconds )
+{
+	if( mStep && mStep( *this, seconds ) ) {
+		mStep = nullptr;
+		sortOutput();
+	}
+	return getPoints();
+}
+
+template<typename VecT, typename URBG>
+void PoissonDiskSamplerT<VecT, URBG>::sortOutput()
+{
+	if( mOrder == PoissonDiskOptions::ACCEPTANCE_ORDER ) {
+		return;
+	}
+	// the grids index the points in acceptance order, sorting happens on a copy
+	if( ! mHasOutput ) {
+		mOutput		= getPoints();
+		mHasOutput	= true;
+	}
+	poisson_detail::sortAlongCurve( &mOutput, mOrder );
+}
+
+template<typename URBG, typename DistFn>
+void poissonDiskDistributionBatch( const DistFn &distFunction, const PoissonDiskJob *jobs, size_t count, std::vector<glm::vec2> *output, std::vector<uint32_t> *offsets, const PoissonDiskOptions &options )
+{
+	// a few contiguous groups of jobs per thread to balance the load, groups keep their points until they're gathered in job order
+	// the number of groups is derived back from their size so that none of them is empty
+	size_t maxGroups	= glm::min( count, poisson_detail::getNumWorkers( options ) * 8 );
+	size_t groupSize	= maxGroups ? ( count + maxGroups - 1 ) / maxGroups : 0;
+	size_t numGroups	= groupSize ? ( count + groupSize - 1 ) / groupSize : 0;
+	std::vector<std::vector<glm::vec2>> groupPoints( numGroups );
+	offsets->assign( count + 1, 0 );
+	poisson_detail::parallelFor( numGroups, [&]( size_t group ) {
+		PoissonDiskSamplerT<glm::vec2, URBG> sampler;
+		PoissonDiskOptions jobOptions = options;
+		std::vector<glm::vec2> &points = groupPoints[group];
+		for( size_t i = group * groupSize; i < glm::min( ( group + 1 ) * groupSize, count ); i++ ) {
+			const PoissonDiskJob &job = jobs[i];
+			const auto &jobPoints = sampler.sample( [&]( const glm::vec2 &p ) { return distFunction( i, p ); }, job.mMinSeparation, job.mMaxSeparation, job.mBounds, std::vector<glm::vec2>(), jobOptions.seed( job.mSeed ) );
+			points.insert( points.end(), jobPoints.begin(), jobPoints.end() );
+			( *offsets )[i + 1] = static_cast<uint32_t>( jobPoints.size() );
+		}
+	}, options );
+	
+	// turn the counts into offsets and gather the groups
+	for( size_t i = 0; i < count; i++ ) {
+		( *offsets )[i + 1] += ( *offsets )[i];
+	}
+	output->resize( offsets->back() );
+	for( size_t group = 0; group < numGroups; group++ ) {
+		std::copy( groupPoints[group].begin(), groupPoints[group].end(), output->begin() + ( *offsets )[group * groupSize] );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+/*
+ Copyright (c) 2015 Simon Geilfus
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+// Benchmarks of the poissonDiskDistribution overloads over a matrix of area size x separation x k, built against
+// Google Benchmark. Each run reports the throughput, the time per candidate, the allocations and peak memory of a
+// single distribution, and the quality of the result so that speedups can't silently degrade the coverage:
+// the minimum distance relative to the minimum separation, which has to stay at or above 1, and the density
+// relative to the densest packing of disks of the minimum separation. Candidates are counted when built with
+// POISSON_DISK_STATS defined, otherwise ~ns/candidate is an estimate from the number of points and k.
+
+#include "PoissonDiskDistribution.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+using namespace std;
+using namespace ci;
+
+// Allocation tracking
+
+namespace {
+	atomic<size_t> sNumAllocations( 0 );
+	atomic<size_t> sCurrentBytes( 0 );
+	atomic<size_t> sPeakBytes( 0 );
+	
+	// every block starts with its size so that deletes can update the current usage
+	const size_t kHeaderSize = alignof( max_align_t ) > sizeof( size_t ) ? alignof( max_align_t ) : sizeof( size_t );
+	
+	void* trackedAlloc( size_t size )
+	{
+		char *block = static_cast<char*>( malloc( size + kHeaderSize ) );
+		if( ! block ) {
+			throw bad_alloc();
+		}
+		*reinterpret_cast<size_t*>( block ) = size;
+		sNumAllocations++;
+		size_t current = sCurrentBytes += size;
+		size_t peak = sPeakBytes;
+		while( current > peak && ! sPeakBytes.compare_exchange_weak( peak, current ) ) {}
+		return block + kHeaderSize;
+	}
+	
+	void trackedFree( void *ptr )
+	{
+		if( ptr ) {
+			char *block = static_cast<char*>( ptr ) - kHeaderSize;
+			sCurrentBytes -= *reinterpret_cast<size_t*>( block );
+			free( block );
+		}
+	}
+}
+
+void* operator new( size_t size ) { return trackedAlloc( size ); }
+void* operator new[]( size_t size ) { return trackedAlloc( size ); }
+void operator delete( void *ptr ) noexcept { trackedFree( ptr ); }
+void operator delete[]( void *ptr ) noexcept { trackedFree( ptr ); }
+void operator delete( void *ptr, size_t ) noexcept { trackedFree( ptr ); }
+void operator delete[]( void *ptr, size_t ) noexcept { trackedFree( ptr ); }
+
+// Quality metrics
+
+namespace {
+	//! returns the minimum distance between two points of \a points, sweeping them along x
+	template<typename VecT>
+	float getMinDistance( vector<VecT> points )
+	{
+		sort( points.begin(), points.end(), []( const VecT &a, const VecT &b ) { return a.x < b.x; } );
+		float minDistance = numeric_limits<float>::max();
+		for( size_t i = 0; i < points.size(); i++ ) {
+			for( size_t j = i + 1; j < points.size() && points[j].x - points[i].x < minDistance; j++ ) {
+				minDistance = glm::min( minDistance, glm::distance( points[i], points[j] ) );
+			}
+		}
+		return minDistance;
+	}
+	
+	//! returns the number of points per unit of area or volume relative to the densest packing of disks or spheres of \a separation
+	float getRelativeDensity( size_t numPoints, float size, float separation, int dimensions )
+	{
+		return dimensions == 2 ? numPoints * separation * separation / ( size * size * 1.1547f ) : numPoints * separation * separation * separation / ( size * size * size * 1.4142f );
+	}
+	
+	//! runs \a sample with \a options in the benchmark loop and reports the performance and quality counters of its result. Without POISSON_DISK_STATS the time per candidate is estimated from the k candidates of each point, and left out when \a isEstimable is false
+	template<typename SampleFn>
+	void runBenchmark( benchmark::State &state, float size, float separation, int dimensions, PoissonDiskOptions options, bool isEstimable, const SampleFn &sample )
+	{
+		size_t numPoints		= 0;
+		size_t numAllocations	= 0;
+		size_t peakBytes		= 0;
+		float minDistance		= 0.0f;
+		bool hasMinDistance		= false;
+		double elapsedNs		= 0.0;
+		PoissonDiskStats stats;
+		options.stats( &stats );
+		for( auto _ : state ) {
+			size_t allocations	= sNumAllocations;
+			size_t baseBytes	= sCurrentBytes;
+			sPeakBytes			= baseBytes;
+			
+			auto start			= chrono::steady_clock::now();
+			auto points			= sample( options );
+			benchmark::DoNotOptimize( points.data() );
+			elapsedNs			+= chrono::duration<double, nano>( chrono::steady_clock::now() - start ).count();
+			
+			numAllocations		= sNumAllocations - allocations;
+			peakBytes			= sPeakBytes - baseBytes;
+			numPoints			= points.size();
+			if( ! hasMinDistance ) {
+				state.PauseTiming();
+				minDistance		= getMinDistance( points );
+				hasMinDistance	= true;
+				state.ResumeTiming();
+			}
+		}
+		
+		// the time per candidate is measured on the wall clock, over the candidates counted by the stats of all the iterations
+		state.counters["points"]		= static_cast<double>( numPoints );
+		state.counters["points/s"]		= benchmark::Counter( static_cast<double>( numPoints ), benchmark::Counter::kIsIterationInvariantRate );
+#if defined( POISSON_DISK_STATS )
+		// the stats count the candidates of every engine
+		(void) isEstimable;
+		double numCandidates			= static_cast<double>( stats.mNumCandidates );
+		state.counters["ns/candidate"]	= numCandidates ? elapsedNs / numCandidates : 0.0;
+#else
+		// or estimated from the k candidates spawned around each accepted point, which ignores initial points, seeded regions, adaptive k and early stops
+		double numCandidates			= static_cast<double>( numPoints ) * options.getK();
+		if( isEstimable ) {
+			state.counters["~ns/candidate"]	= numCandidates ? elapsedNs / ( numCandidates * state.iterations() ) : 0.0;
+		}
+#endif
+		state.counters["allocs"]		= static_cast<double>( numAllocations );
+		state.counters["peakKB"]		= peakBytes / 1024.0;
+		state.counters["minDist"]		= minDistance / separation;
+		state.counters["density"]		= getRelativeDensity( numPoints, size, separation, dimensions );
+	}
+	
+	float getSeparation( const benchmark::State &state )			{ return state.range( 1 ) * 0.1f; }
+	PoissonDiskOptions getOptions( const benchmark::State &state )	{ return PoissonDiskOptions( static_cast<int>( state.range( 2 ) ) ).seed( 1 ); }
+}
+
+// 2D
+
+static void BM_ConstantSeparation( benchmark::State &state )
+{
+	float size			= static_cast<float>( state.range( 0 ) );
+	float separation	= getSeparation( state );
+	runBenchmark( state, size, separation, 2, getOptions( state ), true, [&]( const PoissonDiskOptions &options ) {
+		return poissonDiskDistribution( separation, Rectf( 0, 0, size, size ), vector<vec2>(), options );
+	} );
+}
+
+static void BM_DistFunction( benchmark::State &state )
+{
+	float size			= static_cast<float>( state.range( 0 ) );
+	float separation	= getSeparation( state );
+	// smooth variations between one and three times the separation
+	std::function<float(const vec2&)> distFunction = [=]( const vec2 &p ) { return separation * ( 2.0f + sin( p.x * 0.02f ) * cos( p.y * 0.02f ) ); };
+	runBenchmark( state, size, separation, 2, getOptions( state ), true, [&]( const PoissonDiskOptions &options ) {
+		return poissonDiskDistribution( distFunction, separation, 3.0f * separation, Rectf( 0, 0, size, size ), vector<vec2>(), options );
+	} );
+}
+
+static void BM_DistAndBoundsFunctions( benchmark::State &state )
+{
+	float size			= static_cast<float>( state.range( 0 ) );
+	float separation	= getSeparation( state );
+	// same separation inside the disk inscribed in the area
+	std::function<float(const vec2&)> distFunction = [=]( const vec2 &p ) { return separation * ( 2.0f + sin( p.x * 0.02f ) * cos( p.y * 0.02f ) ); };
+	std::function<bool(const vec2&)> boundsFunction = [=]( const vec2 &p ) { return glm::distance( p, vec2( size * 0.5f ) ) < size * 0.5f; };
+	runBenchmark( state, size, separation, 2, getOptions( state ), true, [&]( const PoissonDiskOptions &options ) {
+		return poissonDiskDistribution( distFunction, separation, 3.0f * separation, boundsFunction, Rectf( 0, 0, size, size ), vector<vec2>(), options );
+	} );
+}
+
+static void BM_DartThrowing( benchmark::State &state )
+{
+	float size			= static_cast<float>( state.range( 0 ) );
+	float separation	= getSeparation( state );
+	// k is the number of rounds, the number of candidates isn't tied to the number of points
+	runBenchmark( state, size, separation, 2, getOptions( state ).engine( PoissonDiskOptions::DART_THROWING ).numThreads( 0 ), false, [&]( const PoissonDiskOptions &options ) {
+		return poissonDiskDistribution( separation, Rectf( 0, 0, size, size ), vector<vec2>(), options );
+	} );
+}
+
+// 3D
+
+static void BM_ConstantSeparation3d( benchmark::State &state )
+{
+	float size			= static_cast<float>( state.range( 0 ) );
+	float separation	= getSeparation( state );
+	runBenchmark( state, size, separation, 3, getOptions( state ), true, [&]( const PoissonDiskOptions &options ) {
+		return poissonDiskDistribution( separation, AxisAlignedBox( vec3( 0.0f ), vec3( size ) ), vector<vec3>(), options );
+	} );
+}
+
+// Neighbor queries
+
+static void BM_GridHasNeighbors( benchmark::State &state )
+{
+	// batches of poisson_detail::kCandidateBatchSize candidates around random points of a full distribution, like the ones of an
+	// active point, queried one by one or by batches. Building with POISSON_DISK_NO_SIMD defined gives the same queries with the scalar row test
+	const int batchSize	= static_cast<int>( state.range( 0 ) );
+	Rectf bounds( 0, 0, 256, 256 );
+	auto points			= poissonDiskDistribution( 1.0f, bounds, vector<vec2>(), PoissonDiskOptions().seed( 1 ) );
+	float cellSize		= poisson_detail::getCellSize( 1.0f, 1.0f );
+	poisson_detail::Grid<vec2> grid( bounds, cellSize, poisson_detail::getCellCapacity( cellSize, 1.0f ) );
+	for( const auto &p : points ) {
+		grid.add( p );
+	}
+	PoissonDiskRandom rng( 1 );
+	vector<vec2> candidates;
+	vec2 center;
+	while( candidates.size() < 1 << 16 ) {
+		if( candidates.size() % poisson_detail::kCandidateBatchSize == 0 ) {
+			center = points[poisson_detail::randInt( rng, points.size() )];
+		}
+		vec2 p = poisson_detail::randAnnulusPoint( rng, center, 1.0f, poisson_detail::DirectionRotation<vec2>(), PoissonDiskOptions::ANNULUS_REJECTION );
+		if( bounds.contains( p ) ) {
+			candidates.push_back( p );
+		}
+	}
+	
+	bool results[poisson_detail::kCandidateBatchSize];
+	double elapsedNs = 0.0;
+	for( auto _ : state ) {
+		auto start = chrono::steady_clock::now();
+		for( size_t i = 0; i < candidates.size(); i += batchSize ) {
+			if( batchSize == 1 ) {
+				results[0] = grid.hasNeighbors( candidates[i], 1.0f );
+			}
+			else {
+				grid.hasNeighbors( &candidates[i], batchSize, 1.0f, results );
+			}
+			benchmark::DoNotOptimize( results );
+		}
+		elapsedNs += chrono::duration<double, nano>( chrono::steady_clock::now() - start ).count();
+	}
+	state.counters["ns/query"] = elapsedNs / ( static_cast<double>( candidates.size() ) * state.iterations() );
+}
+
+// area size x separation in tenths x k
+BENCHMARK( BM_ConstantSeparation )->ArgsProduct( { { 256, 1024 }, { 20, 80 }, { 8, 30 } } )->Unit( benchmark::kMillisecond );
+BENCHMARK( BM_DistFunction )->ArgsProduct( { { 256, 1024 }, { 20, 80 }, { 8, 30 } } )->Unit( benchmark::kMillisecond );
+BENCHMARK( BM_DistAndBoundsFunctions )->ArgsProduct( { { 256, 1024 }, { 20, 80 }, { 8, 30 } } )->Unit( benchmark::kMillisecond );
+BENCHMARK( BM_DartThrowing )->ArgsProduct( { { 256, 1024 }, { 20, 80 }, { 8, 30 } } )->Unit( benchmark::kMillisecond );
+// box size x separation in tenths x k
+BENCHMARK( BM_ConstantSeparation3d )->ArgsProduct( { { 32, 96 }, { 20, 80 }, { 8, 30 } } )->Unit( benchmark::kMillisecond );
+
+// candidates per query
+BENCHMARK( BM_GridHasNeighbors )->Arg( 1 )->Arg( poisson_detail::kCandidateBatchSize )->Unit( benchmark::kMicrosecond );
+
+BENCHMARK_MAIN();
\ No newline at end of file